@@ -47,7 +47,12 @@ if (EXISTS $ENV{VERILATOR_ROOT})
       "${VERILATOR_ROOT}/include/verilated_dpi.cpp"
       "${VERILATOR_ROOT}/include/verilated_save.cpp"
       "$<$<BOOL:${OPT_VCD_ENABLE}>:${VERILATOR_ROOT}/include/verilated_vcd_c.cpp>"
+      "$<$<BOOL:${OPT_FUZZ_ENABLE}>:${VERILATOR_ROOT}/include/verilated_cov.cpp>"
+      "$<$<BOOL:${OPT_PROF_ENABLE}>:${VERILATOR_ROOT}/include/verilated_profiler.cpp>"
       )
+    if (OPT_FUZZ_ENABLE)
+      target_compile_definitions(${vlib} PUBLIC VM_COVERAGE=1)
+    endif ()
     target_include_directories(${vlib}
       PUBLIC
       "${VERILATOR_ROOT}/include"
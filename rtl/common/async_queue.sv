@@ -70,7 +70,9 @@ module async_queue #(
    //                                                                         //
    //======================================================================== //
 
-   //
+   // Status of the queue prior to any push or pop in the current
+   // cycle; derived from state alone, such that either may qualify
+   // the push or pop of the cycle.
    , output logic                            empty_w
    , output logic                            full_w
 );
@@ -122,9 +124,9 @@ module async_queue #(
   always_comb begin : flags_PROC
     
     //
-    empty_w  = (rptr_w == wptr_rsync);
+    empty_w  = (rptr_r == wptr_rsync);
 
-    full_w   = (wptr_w.x ^ rptr_wsync.x) & (wptr_w.a == rptr_wsync.a);
+    full_w   = (wptr_r.x ^ rptr_wsync.x) & (wptr_r.a == rptr_wsync.a);
 
   end // block: flags_PROC
   
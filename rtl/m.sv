@@ -30,27 +30,61 @@
 
 `include "m_pkg.vh"
 
-module m (
+module m #(
+    // Depth of the match pipeline (see: m_match); [0, MATCH_DEPTH_MAX].
+    parameter int MATCH_DEPTH = m_pkg::MATCH_DEPTH_MAX
+    // Capacity (in words) of the egress buffer of each channel (see:
+    // m_egress); a power of two.
+  , parameter int EGRESS_N = m_pkg::EGRESS_N
+) (
 
   // ======================================================================== //
   // Ingress
     input logic                                   in_vld_w
   , input m_pkg::in_t                             in_w
+  // The word presented is accepted only where ready; otherwise, it
+  // must be held (or re-presented) in a later cycle. Derived from
+  // state alone.
+  , output logic                                  in_rdy_w
 
   // ======================================================================== //
   // Egress
   , output logic                                  out_vld_r
   , output m_pkg::out_t                           out_r
 
+  // Egress configuration (host clock domain; static) and the number of
+  // packets discarded on overflow of the egress buffer.
+  , input m_pkg::egress_cfg_t                     cfg_egress_w
+  , output m_pkg::egress_count_t                  out_overflows_r
+
   // ======================================================================== //
-  // Packet type match oprand
+  // Completion ring (host clock domain)
+  //
+  // A descriptor is written to the ring for each packet delivered to
+  // the host, and notifications are coalesced (see: m_cpl). The
+  // consumer reads the descriptor at 'cpl_rd_idx_w', and returns
+  // descriptors to the ring by advancing 'cpl_cons_w'.
   //
-  , input m_pkg::packet_off_t                     packet_type_off_w
-  , input m_pkg::packet_type_t                    packet_type_w
+  , input m_pkg::cpl_cfg_t                        cfg_cpl_w
+  , input m_pkg::cpl_ptr_t                        cpl_cons_w
+  , input m_pkg::cpl_idx_t                        cpl_rd_idx_w
+  , output m_pkg::cpl_desc_t                      cpl_rd_desc_w
+  , output m_pkg::cpl_ptr_t                       cpl_prod_r
+  , output logic                                  cpl_irq_r
+  , output m_pkg::egress_count_t                  cpl_overflows_r
 
   // ======================================================================== //
-  // Mystery ID oprand
-  , input m_pkg::sym_match_t [3:0]                symbol_match_w
+  // Rule table configuration (host clock domain)
+  //
+  // Rule sets are written to the table at index 'cfg_idx_w' and become
+  // visible to packets atomically upon commit. A packet selects its
+  // rule set by index on SOP.
+  //
+  , input logic                                   cfg_vld_w
+  , input m_pkg::rule_idx_t                       cfg_idx_w
+  , input m_pkg::rule_t                           cfg_rule_w
+  , input logic                                   cfg_commit_w
+  , output logic                                  cfg_busy_r
 
   // ======================================================================== //
   // Clk/Reset
@@ -75,74 +109,240 @@ module m (
     logic                got_type;
     logic                got_symbol;
     m_pkg::buffer_t      buffer;
+    m_pkg::sym_slot_t    slot;
   } match_t;
 
+  // Packet context; the state retained across the words of a packet.
+  typedef struct packed {
+    // Byte offset of SOP within the initial word of the packet.
+    m_pkg::len_t               align;
+    // Current 8B word within the packet.
+    m_pkg::packet_word_off_t   word_off;
+    // Initial packet word is yet to be matched.
+    logic                      first;
+    // Packet rule set.
+    m_pkg::rule_entry_t        op;
+  } ctx_t;
+
+  // Channel context; saved on each word of the channel and restored
+  // on the next, such that the packets of distinct channels may be
+  // interleaved word by word.
+  typedef struct packed {
+    ctx_t                      ctx;
+    // Prior valid word of the channel (to realign packets which do
+    // not start at byte 0 of a word).
+    m_pkg::data_t              hold;
+  } chan_ctx_t;
+
+  // Deferred final word of a packet.
+  typedef struct packed {
+    m_pkg::chan_t              chan;
+    ctx_t                      ctx;
+    // Byte offset of the final valid byte of the word.
+    m_pkg::len_t               length;
+  } tail_t;
+
+  // Match pipeline; the state associated with the words presented to
+  // the match logic (and the egress of the cycle), retained until the
+  // match outcome is available.
+  typedef struct packed {
+    logic                      out;
+    logic                      l0;
+  } pipe_vld_t;
+
+  typedef struct packed {
+    m_pkg::out_t               out;
+    // Verdict of the packet ending in 'out' is deferred to the tail
+    // lane.
+    logic                      out_defer;
+    // Word on lane 0 is the initial word of the packet.
+    logic                      l0_first;
+    // Word on lane 0 is the final word of the packet.
+    logic                      l0_end;
+    // Word on the tail lane is the initial word of the packet.
+    logic                      tl_first;
+    // Channel of the word on the tail lane.
+    m_pkg::chan_t              tl_chan;
+  } pipe_t;
+
+  // ======================================================================== //
+  //                                                                          //
+  // Functions                                                                //
+  //                                                                          //
+  // ======================================================================== //
+
+  // Update retained match state with the match outcome of a word.
+  function automatic match_t match_merge(
+      match_t m, logic type_found, logic symbol_found, m_pkg::buffer_t buffer,
+      m_pkg::sym_slot_t slot);
+    match_merge  = m;
+    if (type_found)
+      match_merge.got_type  = 'b1;
+    if (symbol_found) begin
+      match_merge.got_symbol  = 'b1;
+      match_merge.buffer      = buffer;
+      match_merge.slot        = slot;
+    end
+  endfunction
+
+  // Final match decision of a packet. Assign matched buffer if type
+  // and symbol have both been detected in the payload; otherwise,
+  // match conditions were not met, drive zero.
+  function automatic m_pkg::buffer_t match_verdict(match_t m);
+    match_verdict  = (m.got_type & m.got_symbol) ? m.buffer : '0;
+  endfunction
+
+  // Match status of a packet (reported in its completion descriptor).
+  function automatic m_pkg::status_t match_status(match_t m);
+    match_status           = '0;
+    match_status.type_hit  = m.got_type;
+    match_status.hit       = m.got_type & m.got_symbol;
+    if (match_status.hit)
+      match_status.slot    = m.slot;
+  endfunction
+
   // ======================================================================== //
   //                                                                          //
   // Wires                                                                    //
   //                                                                          //
   // ======================================================================== //
 
+  // NET pipeline stall; the pipeline advances only where enabled.
+  logic                                 net_stall;
+  logic                                 net_en;
+
   // Input flops
   logic                                 in_vld_r;
+  logic                                 in_vld_en;
   logic                                 in_en;
   m_pkg::in_t                           in_r;
 
-  // Output flops
+  // Word retained from the prior valid cycle (to form the deferred
+  // final word of a packet).
+  logic                                 hold_en;
+  m_pkg::data_t                         hold_r;
+
+  // Egress stage:
   logic                                 out_vld_w;
-  logic                                 out_en;
   m_pkg::out_t                          out_w;
+  logic                                 out_ack;
+
+  // Channel context RAM:
+  state_t [m_pkg::CHAN_N - 1:0]         fsm_state_r;
+  logic                                 ctx_mem_en;
+  chan_ctx_t [m_pkg::CHAN_N - 1:0]      ctx_mem_r;
+  chan_ctx_t                            ctx_mem_w;
 
   // FSM:
   logic                                 fsm_state_en;
-  state_t                               fsm_state_r;
+  state_t                               fsm_state;
   state_t                               fsm_state_w;
-  logic                                 fsm_oprand_en;
-  logic                                 fsm_word_off_en;
-  m_pkg::packet_word_off_t              fsm_word_off_r;
-  m_pkg::packet_word_off_t              fsm_word_off_w;
-  logic                                 fsm_word_off_inc;
-  logic                                 fsm_buffer_set;
-  logic                                 fsm_can_match;
+  ctx_t                                 fsm_ctx;
+  ctx_t                                 fsm_ctx_w;
+  m_pkg::data_t                         fsm_hold;
+  logic                                 fsm_in_packet;
+  logic                                 fsm_packed;
+  logic                                 fsm_cur_vld;
+  logic                                 fsm_cur_eop;
+  logic                                 fsm_cur_tail;
+  logic                                 fsm_cur_last;
+  m_pkg::data_t                         fsm_cur_word;
+  m_pkg::len_t                          fsm_cur_length;
+  logic                                 fsm_new_vld;
+  logic                                 fsm_new_eop;
+  logic                                 fsm_new_lane;
+  logic                                 fsm_new_tail;
+
+  // Deferred final word:
+  logic                                 tail_vld_r;
+  logic                                 tail_vld_w;
+  logic                                 tail_en;
+  tail_t                                tail_r;
+  tail_t                                tail_w;
+
+  // Lane 0 (words of the current, or newly started, packet):
+  logic                                 l0_vld;
+  m_pkg::data_t                         l0_word;
+  logic                                 l0_last;
+  m_pkg::len_t                          l0_length;
+  m_pkg::packet_word_off_t              l0_word_off;
+  m_pkg::rule_entry_t                   l0_op;
+  logic                                 l0_first;
+  logic                                 l0_type_found;
+  logic                                 l0_symbol_found;
+  m_pkg::buffer_t                       l0_symbol_buffer;
+  m_pkg::sym_slot_t                     l0_symbol_slot;
+  match_t                               l0_match;
+
+  // Tail lane (deferred final word of the prior packet):
+  m_pkg::data_t                         tl_word;
+  logic                                 tl_type_found;
+  logic                                 tl_symbol_found;
+  m_pkg::buffer_t                       tl_symbol_buffer;
+  m_pkg::sym_slot_t                     tl_symbol_slot;
+  match_t                               tl_match;
 
   logic                                 net_out_vld;
+  logic                                 net_out_defer;
   m_pkg::out_t                          net_out;
 
-  // AFIFO
+  // Match pipeline (registered where MATCH_DEPTH > 0):
+  pipe_vld_t                            pipe_vld_w;
+  pipe_t                                pipe_w;
+  pipe_vld_t                            pipe_vld;
+  pipe_t                                pipe;
+
+  // Match status of the packet in progress on each channel, retained
+  // across words:
+  logic                                 acc_en;
+  match_t [m_pkg::CHAN_N - 1:0]         acc_r;
+  match_t                               acc_w;
+
+  // Egress stage:
+  logic                                 egress_vld_r;
+  logic                                 egress_defer_r;
+  logic                                 egress_en;
+  m_pkg::out_t                          egress_r;
+  m_pkg::out_t                          egress_w;
+
+  // AFIFO (data path)
   logic                                 afifo_push;
-  m_pkg::out_t                          afifo_push_data;
+  m_pkg::afifo_data_t                   afifo_push_data;
   logic                                 afifo_pop;
-  m_pkg::out_t                          afifo_pop_data;
-  logic                                 afifo_empty_r;
+  m_pkg::afifo_data_t                   afifo_pop_data;
   logic                                 afifo_empty_w;
-
-  // FSM oprands:
-  m_pkg::packet_off_t                   packet_type_off_r;
-  m_pkg::packet_type_t                  packet_type_r;
-  m_pkg::sym_match_t [3:0]              symbol_match_r;
-
-  // match_packet_type_PROC
-  logic                                 match_type_in_word;
-  logic [7:0]                           match_valid_mask;
-  logic                                 match_type_off_in_range;
-  logic [4:0]                           match_type_found_pos;
-  logic                                 match_type_found;
-
-  // match_symbol_PROC
-  logic                                 match_symbol_can_match_word;
-  logic [3:0]                           match_symbol_can_match;
-  logic                                 match_symbol_did_match;
-  logic                                 match_symbol_found;
-  m_pkg::buffer_t                       match_symbol_buffer;
-
-  // match concensus
-  match_t                               match_r;
-  match_t                               match_w;
-  logic                                 match_en;
-
-  logic                                 match_got_type;
-  logic                                 match_got_symbol;
-  m_pkg::buffer_t                       match_buffer;
+  logic                                 afifo_full_w;
+
+  // VFIFO (verdict path)
+  logic                                 vfifo_push;
+  m_pkg::vfifo_data_t                   vfifo_push_data;
+  logic                                 vfifo_pop;
+  m_pkg::vfifo_data_t                   vfifo_pop_data;
+  logic                                 vfifo_empty_w;
+  logic                                 vfifo_full_w;
+
+  // Rule table (host):
+  logic                                 cfg_wr_en;
+  logic                                 cfg_commit_en;
+  logic                                 cfg_ack;
+  logic                                 cfg_busy_w;
+  logic                                 cfg_commit_tgl_r;
+  logic                                 cfg_commit_tgl_w;
+  logic                                 cfg_ack_tgl_hsync;
+  logic [m_pkg::RULE_N - 1:0]           cfg_bank_r;
+  logic [m_pkg::RULE_N - 1:0]           cfg_bank_w;
+  logic [m_pkg::RULE_N - 1:0]           cfg_dirty_r;
+  logic [m_pkg::RULE_N - 1:0]           cfg_dirty_w;
+  m_pkg::rule_entry_t                   cfg_entry_w;
+  m_pkg::rule_entry_t [1:0][m_pkg::RULE_N - 1:0] rule_mem_r;
+
+  // Rule table (net):
+  logic                                 rule_commit_tgl_nsync;
+  logic                                 rule_ack_tgl_r;
+  logic                                 rule_swap;
+  logic [m_pkg::RULE_N - 1:0]           rule_bank_r;
+  logic [m_pkg::RULE_N - 1:0]           rule_bank_w;
+  m_pkg::rule_entry_t                   rule_rd;
 
   // ======================================================================== //
   //                                                                          //
@@ -152,339 +352,367 @@ module m (
   
   // ------------------------------------------------------------------------ //
   //
-  always_comb begin : in_PROC
+  always_comb begin : stall_PROC
 
-    // Latch input.
-    in_en  = in_vld_w;
+    // The word in the egress stage cannot be pushed to a full queue:
+    // every word is pushed to the data path, and an EOP word also to
+    // the verdict path. The NET pipeline, from the ingress to the
+    // egress stage, is then stalled in its entirety (and the ingress
+    // refuses further words) until the queue has drained.
+    //
+    net_stall  = egress_vld_r & (afifo_full_w | (egress_r.eop & vfifo_full_w));
+    net_en     = (~net_stall);
+
+    in_rdy_w   = net_en;
+
+  end // block: stall_PROC
 
-  end // block: in_PROC
-  
   // ------------------------------------------------------------------------ //
   //
-  always_comb begin : fsm_PROC
+  always_comb begin : in_PROC
 
-    // Defaults
-    //
-    fsm_state_en      = 'b0;
-    fsm_state_w       = fsm_state_r;
+    // Latch input.
+    in_vld_en    = net_en;
+    in_en        = in_vld_w & net_en;
 
-    // Latch oprands on cycle preceeding SOP at the input latch such
-    // that the the state is preloaded for the first word.
-    //
-    fsm_oprand_en     = (in_vld_w & in_w.sop);
+    // Retain last valid word.
+    hold_en      = in_vld_r & net_en;
 
-    fsm_word_off_inc  = 'b0;
+  end // block: in_PROC
+
+  // ------------------------------------------------------------------------ //
+  // Rule table configuration (host clock domain). Each rule set is
+  // double-buffered: writes are directed to the inactive copy of the
+  // entry and are marked dirty. A commit requests that the NET clock
+  // domain swap all dirty entries in a single cycle, such that rule
+  // sets may be updated atomically without disrupting traffic. Further
+  // configuration is disallowed until the swap has been acknowledged.
+  //
+  always_comb begin : cfg_PROC
 
-    fsm_buffer_set    = 'b0;
+    cfg_wr_en         = cfg_vld_w & (~cfg_busy_r);
+    cfg_commit_en     = cfg_commit_w & (~cfg_busy_r);
 
-    // Flag denotes whether the word present in in_r contains state
-    // that is currently matchable (contains valid payload data). This
-    // is derived from the current FSM state.
+    // Request toggles on commit; swap is acknowledged once the toggle
+    // has been returned from the NET clock domain.
     //
-    fsm_can_match     = 'b0;
+    cfg_commit_tgl_w  = cfg_commit_tgl_r ^ cfg_commit_en;
+    cfg_ack           = cfg_busy_r & (cfg_commit_tgl_r == cfg_ack_tgl_hsync);
+    cfg_busy_w        = cfg_commit_en | (cfg_busy_r & (~cfg_ack));
 
-    // Outputs to AFIFO
+    // The dirty set is retained (static) whilst the commit is
+    // outstanding as it is sampled by the NET clock domain.
     //
-    net_out_vld       = 'b0;
+    cfg_dirty_w       = cfg_ack ? '0 : cfg_dirty_r;
+    if (cfg_wr_en)
+      cfg_dirty_w [cfg_idx_w]  = 'b1;
 
-    // For all fields aside from 'buffer' simply forward input to
-    // output.
+    // Track the active copy of each entry as seen by the NET clock
+    // domain.
     //
-    net_out           = '0;
-    net_out.sop       = in_r.sop;
-    net_out.eop       = in_r.eop;
-    net_out.length    = in_r.length;
-    net_out.data      = in_r.data;
+    cfg_bank_w        = cfg_ack ? (cfg_bank_r ^ cfg_dirty_r) : cfg_bank_r;
 
-    // FSM state update:
+    // Derive Bloom filter of the rule set's symbols as it is written.
     //
-    case (fsm_state_r)
-      IDLE: begin
-        case ({in_vld_r, in_r.sop, in_r.eop}) inside
-          3'b1_1_0: begin
-            // Detected pakcet that is > 8B in length
-
-            // Advance packet offset
-            fsm_word_off_inc  = 'b1;
-
-            // Is matchable word
-            fsm_can_match      = 'b1;
-
-            // Drive output
-            net_out_vld       = 'b1;
-
-            // Advance to packet body state
-            fsm_state_en      = 'b1;
-            fsm_state_w       = IN_PACKET;
-          end
-          3'b1_1_1: begin
-            // Detected packet that is <= 8B in length
-
-            // Drive buffer as this is a valid EOP.
-            fsm_buffer_set  = 'b1;
-
-            // Is matchable word
-            fsm_can_match   = 'b1;
+    cfg_entry_w       = '0;
+    cfg_entry_w.rule  = cfg_rule_w;
+    for (int i = 0; i < 4; i++) begin
+      if (cfg_rule_w.symbol [i].valid) begin
+        cfg_entry_w.bloom [m_pkg::bloom_h0(cfg_rule_w.symbol [i].match)]  = 'b1;
+        cfg_entry_w.bloom [m_pkg::bloom_h1(cfg_rule_w.symbol [i].match)]  = 'b1;
+      end
+    end
 
-            // Drive output
-            net_out_vld     = 'b1;
+  end // block: cfg_PROC
 
-            // Remain in IDLE state
-          end // case: 3'b1_1_1
-          default: begin
-            // Otherwise, synchronize to the most recent SOP.
-          end
-        endcase
-      end
-      IN_PACKET: begin
-        case ({in_vld_r, in_r.eop}) inside
-          2'b1_0: begin
-            // Word within the body of the current packet (not the
-            // tail word).
-            fsm_word_off_inc  = 'b1;
-
-            // Is matchable word
-            fsm_can_match     = 'b1;
-
-            // Drive output
-            net_out_vld       = 'b1;
-
-            // Remain in current state
-          end
-          2'b1_1: begin
-            // Final word in current packet.
-
-            // Drive buffer as this is a valid EOP
-            fsm_buffer_set  = 'b1;
-
-            // Is matchable word
-            fsm_can_match    = 'b1;
-
-            // Drive output
-            net_out_vld     = 'b1;
-
-            // Return to IDLE state; packet is complete.
-            fsm_state_en    = 'b1;
-            fsm_state_w     = IDLE;
-          end
-          default: begin
-            // Otherwise, ignore cycle with no valid state.
-          end
-        endcase
-      end
-      default: begin
-      end
-    endcase // case (state_r)
+  // ------------------------------------------------------------------------ //
+  // Rule table lookup (NET clock domain).
+  //
+  always_comb begin : rule_PROC
 
-    // Counter denoting the current 8B word within the current packet.
+    // Swap dirty entries upon detection of a commit request. The
+    // dirty set is quasi-static at this point, having been stable for
+    // the duration of the commit synchronization. The swap is
+    // deferred whilst stalled, such that a word held at the ingress
+    // observes the rule table current when it was accepted.
     //
-    fsm_word_off_en   = (fsm_oprand_en | fsm_word_off_inc);
-    fsm_word_off_w    = fsm_oprand_en ? '0 : fsm_word_off_r + 'd1;
+    rule_swap    = (rule_commit_tgl_nsync != rule_ack_tgl_r) & net_en;
+    rule_bank_w  = rule_bank_r ^ cfg_dirty_r;
 
-    // Compute 'got match' status as a function of the word on the current
-    // cycle, or the matched status retained from prior cycles.
+    // Lookup rule set of the packet starting in the current word. The
+    // inactive copy of an entry is never read, as such the table may
+    // be safely written from the HOST clock domain.
     //
-    match_got_type    =
-      match_r.got_type | (fsm_can_match ? match_type_found : '0);
-    match_got_symbol  =
-      match_r.got_symbol | (fsm_can_match ? match_symbol_found : '0);
-    match_buffer      =
-      (fsm_can_match & match_symbol_found) ? match_symbol_buffer : match_r.buffer;
-    
-    // Drive computed 'buffer' oprand based upon whether a match has
-    // been encountered during the current packet.
-    //
-    case ({fsm_buffer_set, match_got_type, match_got_symbol}) inside
-      3'b1_1_1:
-        // Assign matched buffer on EOP if type and symbol have both
-        // been detected in the payload
-        net_out.buffer  = match_buffer;
-      default:
-        // Otherwise, match conditions were not met, drive zero.
-        net_out.buffer   = '0;
-    endcase // casez ({fsm_buffer_set})
-    
-  end // block: fsm_PROC
+    rule_rd      = rule_mem_r [rule_bank_r [in_r.rule]][in_r.rule];
+
+  end // block: rule_PROC
   
   // ------------------------------------------------------------------------ //
-  // Type is a 4B quantity which is constrained to fall within a
-  // single 8B word. The type field may not straddle multiple
-  // words. Therefore, the type field may be aligned to the following
-  // locations within the word:
-  //
-  //   [3:0], [4:1], [5:2], [6:3], [7:4]
-  //
-  // Locations:
+  // Packets need not start at byte 0 of a word, and a word may end
+  // one packet and start the next. Matching is carried out on words
+  // realigned to the packet: for a packet starting at byte 'align', a
+  // packet word is formed from bytes [7:align] of the prior word and
+  // bytes [align-1:0] of the current word. A packet word therefore
+  // completes on each word after the SOP word (or on every word, when
+  // align == 0). Where the final bytes of a packet do not complete a
+  // word, they are matched in the following cycle as a deferred
+  // "tail" word, concurrently with the words of the next packet. As
+  // such, two packet contexts may be active in any one cycle.
   //
-  //   [<=2:A] and [B:>=5]
+  // Packets of up to CHAN_N channels may be interleaved word by word.
+  // The state of the packet in progress on each channel (FSM state,
+  // packet context and the prior word of the channel) is retained in
+  // a context RAM; the context of the channel of the current word is
+  // restored, updated and saved in the same cycle, such that
+  // interleaved packets are matched at full rate. The deferred final
+  // word is matched in the cycle following the final word of its
+  // channel, irrespective of the channel of that cycle, and the tail
+  // register is therefore shared by all channels.
   //
-  // are impermissible and are therefore ingored.
-  //
-  always_comb begin : match_type_PROC
-    
-    // Mask denoting the valid bytes within the current word. Length
-    // is only considered on EOP.
+  always_comb begin : fsm_PROC
+
+    // Restore the context of the channel.
     //
-    match_valid_mask    =
-      m_pkg::len_to_unary_mask(in_r.length) | {8{~in_r.eop}};
+    fsm_state       = fsm_state_r [in_r.chan];
+    fsm_ctx         = ctx_mem_r [in_r.chan].ctx;
+    fsm_hold        = ctx_mem_r [in_r.chan].hold;
 
-    // Flag denoting that the current type is expected somewhere
-    // within the current word.
+    // Defaults
     //
-    match_type_in_word  = (fsm_word_off_r == packet_type_off_r.word);
+    fsm_state_en    = 'b0;
+    fsm_state_w     = fsm_state;
+    fsm_ctx_w       = fsm_ctx;
+
+    fsm_in_packet   = (fsm_state == IN_PACKET);
 
-    // Byte comparison logic for each of the valid matching regions.
+    // Word ends the packet in progress and starts the next.
     //
-    for (int i = 0; i < 5; i++) begin
-      match_type_found_pos [i]  = '1;
-      for (int j = 0; j < 4; j++) begin
-        match_type_found_pos[i] &= match_valid_mask[i + j]
-          ? (packet_type_r[j] == in_r.data[i + j]) : '0;
-      end
-    end
+    fsm_packed      = in_r.sop & in_r.eop & (in_r.sop_off > in_r.length);
 
-    // The type falls within a single 8B word and is 4B in length. As
-    // such, the only permissible starting locations for the type in
-    // the 8B word are: 0, 1, 2, 3, 4 (as above).
+    // Word continues the packet in progress. A SOP, other than in a
+    // packed word, denotes a new packet without the EOP of the prior
+    // packet; in which case, synchronize to the most recent SOP.
     //
-    match_type_off_in_range  = (packet_type_off_r.off <= 'd4);
+    fsm_cur_vld     = in_vld_r & fsm_in_packet & ((~in_r.sop) | fsm_packed);
+    fsm_cur_eop     = fsm_cur_vld & in_r.eop;
 
-    // Compute final type match within current word.
+    // Packet word of the packet in progress completing in the current
+    // cycle.
     //
-    case ({in_vld_r, match_type_in_word, match_type_off_in_range}) inside
-      3'b1_1_1:
-        // Possibly found whenever current word is valid and we are in the
-        // word where the type is expected to be found.
-        match_type_found  = match_type_found_pos [packet_type_off_r.off];
-      default:
-        // Otherwise, not found:
-        match_type_found  = 'b0;
-    endcase
+    fsm_cur_word    = (fsm_ctx.align == '0)
+      ? in_r.data
+      : m_pkg::data_t'({in_r.data, fsm_hold} >> {fsm_ctx.align, 3'b000});
 
-  end // block: match_type_PROC
+    // Byte offset of the final byte in the final packet word. Where
+    // the final bytes of the current word do not complete a packet
+    // word, the final packet word is deferred.
+    //
+    fsm_cur_length  = in_r.length - fsm_ctx.align;
+    fsm_cur_tail    =
+      fsm_cur_eop & (fsm_ctx.align != '0) & (in_r.length >= fsm_ctx.align);
+    fsm_cur_last    = fsm_cur_eop & (~fsm_cur_tail);
 
-  // ------------------------------------------------------------------------ //
-  // Block to detect the presence of the associate 'match'
-  // symbol.
-  //
-  // Caveat: The problem statement makes no explicit reference to the
-  // expected alignment of the 'symbol'. As the preceeding operation
-  // is constrained such that the type may not straddle multiple 8B
-  // words, it is too assumed that this remains the case here.
-  //
-  always_comb begin : match_symbol_PROC
+    // Word starts a new packet, which may also end within the word.
+    //
+    fsm_new_vld     = in_vld_r & in_r.sop;
+    fsm_new_eop     = fsm_new_vld & in_r.eop & (~fsm_packed);
 
-    // A symbol is 8B therefore a match can occur only when the entire
-    // 8B word is valid.
+    // A new packet aligned to byte 0 completes its initial packet
+    // word in the current cycle. A new, unaligned packet ending in
+    // the current word is deferred in its entirety.
     //
-    match_symbol_can_match_word  = (~in_r.eop) | (in_r.length == 'd7);
+    fsm_new_lane    = fsm_new_vld & (in_r.sop_off == '0);
+    fsm_new_tail    = fsm_new_eop & (in_r.sop_off != '0);
 
-    // Each match entity contains a specific SYMBOL_OFFSET value which
-    // denotes the word in which the match operation can take
-    // place. The match is not attempted it the current word is not at
-    // the required location. Caveat: I have added an additional valid
-    // field to the structure such that the match will not take place
-    // unless the value has been appropriately configured.
+    // Lane 0: the word of the packet in progress, or of the newly
+    // started packet (mutually exclusive, as the packet in progress
+    // cannot end in a word starting a new packet at byte 0).
     //
-    for (int i = 0; i < 4; i++) begin
-      match_symbol_can_match [i]  =
-        symbol_match_r [i].valid &
-         (fsm_word_off_r == symbol_match_r [i].off);
+    l0_vld          = fsm_cur_vld | fsm_new_lane;
+    if (fsm_new_lane) begin
+      l0_word        = in_r.data;
+      l0_last        = fsm_new_eop;
+      l0_length      = in_r.length;
+      l0_word_off    = '0;
+      l0_op          = rule_rd;
+      l0_first       = 'b1;
+    end else begin
+      l0_word        = fsm_cur_word;
+      l0_last        = fsm_cur_last;
+      l0_length      = fsm_cur_length;
+      l0_word_off    = fsm_ctx.word_off;
+      l0_op          = fsm_ctx.op;
+      l0_first       = fsm_ctx.first;
     end
 
-    // Flag denoting when a match occurred in the current word (an
-    // explicit flag is necessary here as if this detection was only
-    // carried out on the "_buffer" value when non-zero, the logic
-    // could not detect the buffer == '0 case).
+    // Tail lane: the deferred final word of the prior packet, formed
+    // from the prior valid word (the final word of its channel).
     //
-    match_symbol_did_match     = 'b0;
+    tl_word         = m_pkg::data_t'(hold_r >> {tail_r.ctx.align, 3'b000});
 
-    // Comparator logic:
-    //
-    // Note: this is a 4-Way priority decoded structure. The problem
-    // statement does not specifically reference what to do whenever
-    // multiple matches occur in the same cycle. It would be assumed
-    // that this case would represent a misconfigured system which
-    // would not occur in practice, however to prevent corruption on
-    // the key, the code simply selects the highest endian match.
+    // FSM state update:
     //
-    match_symbol_buffer        = '0;
-    for (int i = 0; i < 4; i++) begin
-      if (match_symbol_can_match [i] &&
-         (in_r.data == symbol_match_r [i].match)) begin
-        match_symbol_did_match |= 'b1;
-        match_symbol_buffer     = symbol_match_r [i].buffer;
+    if (fsm_new_vld) begin
+      // Synchronize to the most recent SOP.
+      fsm_state_en  = 'b1;
+      if (fsm_new_eop) begin
+        // Packet is contained within the current word; remain in, or
+        // return to, IDLE.
+        fsm_state_w  = IDLE;
+      end else begin
+        // Advance to packet body state
+        fsm_state_w         = IN_PACKET;
+        fsm_ctx_w.align     = in_r.sop_off;
+        fsm_ctx_w.op        = rule_rd;
+        fsm_ctx_w.word_off  = fsm_new_lane ? 'd1 : '0;
+        fsm_ctx_w.first     = (~fsm_new_lane);
       end
+    end else if (fsm_cur_vld) begin
+      if (in_r.eop) begin
+        // Final word in current packet; return to IDLE state.
+        fsm_state_en  = 'b1;
+        fsm_state_w   = IDLE;
+      end else begin
+        // Word within the body of the current packet (not the tail
+        // word).
+        fsm_ctx_w.word_off  = fsm_ctx.word_off + 'd1;
+        fsm_ctx_w.first     = 'b0;
+      end
+    end
+
+    // Defer final word:
+    //
+    tail_vld_w      = fsm_cur_tail | fsm_new_tail;
+    tail_en         = tail_vld_w & net_en;
+    tail_w          = '0;
+    tail_w.chan     = in_r.chan;
+    if (fsm_cur_tail) begin
+      tail_w.ctx           = fsm_ctx;
+      tail_w.ctx.word_off  = fsm_ctx.word_off + 'd1;
+      // The prior words of the packet are matched on lane 0 in the
+      // current cycle, or before.
+      tail_w.ctx.first     = 'b0;
+      tail_w.length        = fsm_cur_length;
+    end else begin
+      tail_w.ctx.align     = in_r.sop_off;
+      tail_w.ctx.op        = rule_rd;
+      tail_w.ctx.first     = 'b1;
+      tail_w.length        = in_r.length - in_r.sop_off;
     end
 
-    // Compute final match decision.
+    // Outputs to AFIFO. Words not associated with a packet are
+    // discarded.
     //
-    case ({in_vld_r, match_symbol_can_match_word}) inside
-      2'b1_1:
-        // Take the did_match value if the current word is
-        // "matchable".
-        match_symbol_found  = match_symbol_did_match;
-      default:
-        // Otherwise, no match took place.
-        match_symbol_found  = 'b0;
-    endcase // casez ({in_vld_r, match_symbol_can_match})
-    
-  end // block: match_symbol_PROC
+    net_out_vld     = in_vld_r & (fsm_in_packet | in_r.sop);
+
+    // For all fields aside from 'buffer' simply forward input to
+    // output.
+    //
+    net_out         = '0;
+    net_out.chan    = in_r.chan;
+    net_out.sop     = in_r.sop;
+    net_out.eop     = fsm_cur_eop | fsm_new_eop;
+    net_out.sop_off = in_r.sop_off;
+    net_out.length  = in_r.length;
+    net_out.data    = in_r.data;
+
+    // The verdict of a packet ending in a deferred final word is
+    // computed on the tail lane in the following cycle.
+    //
+    net_out_defer   = fsm_cur_tail | fsm_new_tail;
+
+    // Present words to the match pipeline.
+    //
+    pipe_vld_w.out    = net_out_vld;
+    pipe_vld_w.l0     = l0_vld;
+    pipe_w.out        = net_out;
+    pipe_w.out_defer  = net_out_defer;
+    pipe_w.l0_first   = l0_first;
+    pipe_w.l0_end     = l0_vld & l0_last;
+    pipe_w.tl_first   = tail_r.ctx.first;
+    pipe_w.tl_chan    = tail_r.chan;
+
+    // Save the context of the channel; the word is retained to
+    // realign the next word of the channel.
+    //
+    ctx_mem_en      = in_vld_r & net_en;
+    ctx_mem_w.ctx   = fsm_ctx_w;
+    ctx_mem_w.hold  = in_r.data;
+
+  end // block: fsm_PROC
 
   // ------------------------------------------------------------------------ //
+  // Match outcomes are accumulated upon exit from the match pipeline,
+  // such that the depth of the pipeline is not visible to the FSM. The
+  // match status of the packet in progress on each channel is
+  // retained across the words of the channel. The deferred final word
+  // of a packet is matched on the tail lane one cycle after the prior
+  // words of the packet on lane 0; lane 0 then carries, at most, the
+  // initial word of the next packet of the channel, or a word of
+  // another channel.
   //
-  always_comb begin : match_PROC
-
-    //
-    case ({fsm_oprand_en, fsm_can_match}) inside
-      2'b1_?:
-        // Clear retained state
-        match_en  = 'b1;
-      2'b0_1:
-        // Latch update state as necessary.
-        match_en  = (match_type_found | match_symbol_found);
-      default:
-        // Otherwise, retain prior
-        match_en  = 'b0;
-    endcase // casez ({fsm_oprand_en, fsm_can_match})
-
-    // Defaults:
-    match_w  = match_r;
-
-    // Updates
-    case ({fsm_oprand_en, fsm_can_match}) inside
-      2'b1_?:
-        // New packet in next cycle therefore clear retained state.
-        match_w   = 'b0;
-      2'b0_1: begin
-        // In a matchable word, therefore latch any matches.
-        
-        if (match_type_found)
-          match_w.got_type  = 'b1;
-
-        if (match_symbol_found) begin
-          match_w.got_symbol  = 'b1;
-          match_w.buffer  = match_symbol_buffer;
-        end
+  always_comb begin : acc_PROC
 
-      end
-      default:
-        // Otherwise, retain
-        match_w  = match_r;
-    endcase
+    // Compute 'got match' status as a function of the word on the
+    // current cycle, or the matched status retained from prior words
+    // of the channel.
+    //
+    l0_match   = match_merge(pipe.l0_first ? '0 : acc_r [pipe.out.chan],
+                             l0_type_found, l0_symbol_found, l0_symbol_buffer,
+                             l0_symbol_slot);
+    tl_match   = match_merge(pipe.tl_first ? '0 : acc_r [pipe.tl_chan],
+                             tl_type_found, tl_symbol_found, tl_symbol_buffer,
+                             tl_symbol_slot);
+
+    acc_en     = pipe_vld.l0 & net_en;
+    acc_w      = l0_match;
+
+    // Drive computed 'buffer' oprand based upon whether a match has
+    // been encountered during the packet ending in the current word,
+    // or defer until the final word of the packet has been matched.
+    //
+    egress_w   = pipe.out;
+    if (pipe.l0_end) begin
+      egress_w.status  = match_status(l0_match);
+      egress_w.buffer  = match_verdict(l0_match);
+    end
+
+  end // block: acc_PROC
 
-  end // block: match_PROC
-  
   // ------------------------------------------------------------------------ //
   //
   always_comb begin : afifo_PROC
 
-    // Push from FSM
-    afifo_push       = net_out_vld;
-    afifo_push_data  = net_out;
+    // Words are emitted one cycle after the match pipeline, such that
+    // the verdict of a deferred final word is available.
+    //
+    egress_en        = pipe_vld.out & net_en;
 
-    // Self-pop whenever non-empty.
-    afifo_pop        = (~afifo_empty_r);
+    // Push from egress stage; every word is pushed to the data path,
+    // and the EOP sideband of each packet to the verdict path (not
+    // whilst stalled on either).
+    //
+    afifo_push               = egress_vld_r & net_en;
+    afifo_push_data          = '0;
+    afifo_push_data.chan     = egress_r.chan;
+    afifo_push_data.sop      = egress_r.sop;
+    afifo_push_data.eop      = egress_r.eop;
+    afifo_push_data.sop_off  = egress_r.sop_off;
+    afifo_push_data.data     = egress_r.data;
+
+    vfifo_push               = egress_vld_r & egress_r.eop & net_en;
+    vfifo_push_data          = '0;
+    vfifo_push_data.length   = egress_r.length;
+    vfifo_push_data.status   = egress_defer_r ? match_status(tl_match)
+                                              : egress_r.status;
+    vfifo_push_data.buffer   = egress_defer_r ? match_verdict(tl_match)
+                                              : egress_r.buffer;
+
+    // Pop whenever a word is present and accepted by the egress
+    // stage (see: out_PROC).
+    //
+    afifo_pop                = out_vld_w & out_ack;
+    vfifo_pop                = afifo_pop & afifo_pop_data.eop;
 
   end // block: afifo_PROC
   
@@ -492,12 +720,26 @@ module m (
   //
   always_comb begin : out_PROC
 
-    // Emit output on pop
-    out_vld_w  = afifo_pop;
-
-    // Latch output state
-    out_en     = afifo_pop;
-    out_w      = afifo_pop_data;
+    // Present the word at the head of the queue to the egress stage.
+    // The sideband of a packet is pushed alongside its final word, and
+    // therefore crosses no later; an EOP is nonetheless retained until
+    // its sideband is present.
+    //
+    out_vld_w       =
+      (~afifo_empty_w) & ((~afifo_pop_data.eop) | (~vfifo_empty_w));
+
+    // Realign the sideband with the final word of the packet.
+    out_w           = '0;
+    out_w.chan      = afifo_pop_data.chan;
+    out_w.sop       = afifo_pop_data.sop;
+    out_w.eop       = afifo_pop_data.eop;
+    out_w.sop_off   = afifo_pop_data.sop_off;
+    out_w.data      = afifo_pop_data.data;
+    if (afifo_pop_data.eop) begin
+      out_w.length  = vfifo_pop_data.length;
+      out_w.status  = vfifo_pop_data.status;
+      out_w.buffer  = vfifo_pop_data.buffer;
+    end
 
   end // block: out_PROC
   
@@ -512,7 +754,7 @@ module m (
   always_ff @(posedge clk_net)
     if (rst_net)
       in_vld_r <= 'b0;
-    else
+    else if (in_vld_en)
       in_vld_r <= in_vld_w;
 
   // ------------------------------------------------------------------------ //
@@ -520,58 +762,136 @@ module m (
   always_ff @(posedge clk_net)
     if (in_en)
       in_r <= in_w;
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk_net)
+    if (hold_en)
+      hold_r <= in_r.data;
   
   // ------------------------------------------------------------------------ //
+  // Channel context RAM; read asynchronously (distributed RAM) such
+  // that the context saved by a word is restored by the next word of
+  // the channel, in the following cycle, without bypass.
   //
   always_ff @(posedge clk_net)
-    if (fsm_word_off_en)
-      fsm_word_off_r <= fsm_word_off_w;
+    if (ctx_mem_en)
+      ctx_mem_r [in_r.chan] <= ctx_mem_w;
   
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk_net)
+    if (rst_net) begin
+      for (int i = 0; i < m_pkg::CHAN_N; i++)
+        fsm_state_r [i] <= IDLE;
+    end else if (fsm_state_en & net_en)
+      fsm_state_r [in_r.chan] <= fsm_state_w;
+
   // ------------------------------------------------------------------------ //
   //
   always_ff @(posedge clk_net)
     if (rst_net)
-      fsm_state_r <= IDLE;
-    else if (fsm_state_en)
-      fsm_state_r <= fsm_state_w;
-  
+      tail_vld_r <= 'b0;
+    else if (net_en)
+      tail_vld_r <= tail_vld_w;
+
   // ------------------------------------------------------------------------ //
   //
   always_ff @(posedge clk_net)
-    if (fsm_oprand_en) begin
-      packet_type_off_r <= packet_type_off_w;
-      packet_type_r     <= packet_type_w;
+    if (tail_en)
+      tail_r <= tail_w;
 
-      symbol_match_r    <= symbol_match_w;
+  // ------------------------------------------------------------------------ //
+  //
+  if (MATCH_DEPTH > 0) begin : g_pipe_r
+
+    pipe_vld_t [MATCH_DEPTH - 1:0]      pipe_vld_r;
+    pipe_t [MATCH_DEPTH - 1:0]          pipe_r;
+
+    always_ff @(posedge clk_net)
+      if (rst_net)
+        pipe_vld_r <= '0;
+      else if (net_en) begin
+        for (int i = MATCH_DEPTH - 1; i > 0; i--)
+          pipe_vld_r [i] <= pipe_vld_r [i - 1];
+        pipe_vld_r [0] <= pipe_vld_w;
+      end
+
+    always_ff @(posedge clk_net)
+      if (net_en) begin
+        for (int i = MATCH_DEPTH - 1; i > 0; i--)
+          pipe_r [i] <= pipe_r [i - 1];
+        pipe_r [0] <= pipe_w;
+      end
+
+    always_comb begin
+      pipe_vld  = pipe_vld_r [MATCH_DEPTH - 1];
+      pipe      = pipe_r [MATCH_DEPTH - 1];
     end
-  
+
+  end else begin : g_pipe_w
+
+    always_comb begin
+      pipe_vld  = pipe_vld_w;
+      pipe      = pipe_w;
+    end
+
+  end
+
   // ------------------------------------------------------------------------ //
   //
   always_ff @(posedge clk_net)
-    if (match_en)
-      match_r <= match_w;
-  
+    if (acc_en)
+      acc_r [pipe.out.chan] <= acc_w;
+
   // ------------------------------------------------------------------------ //
   //
-  always_ff @(posedge clk_host)
-    if (rst_host)
-      out_vld_r <= 'b0;
-    else
-      out_vld_r <= out_vld_w;
-  
+  always_ff @(posedge clk_net)
+    if (rst_net) begin
+      egress_vld_r   <= 'b0;
+      egress_defer_r <= 'b0;
+    end else if (net_en) begin
+      egress_vld_r   <= pipe_vld.out;
+      egress_defer_r <= pipe_vld.out & pipe.out_defer;
+    end
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk_net)
+    if (egress_en)
+      egress_r <= egress_w;
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk_net)
+    if (rst_net) begin
+      rule_ack_tgl_r <= 'b0;
+      rule_bank_r    <= '0;
+    end else if (rule_swap) begin
+      rule_ack_tgl_r <= rule_commit_tgl_nsync;
+      rule_bank_r    <= rule_bank_w;
+    end
+
   // ------------------------------------------------------------------------ //
   //
   always_ff @(posedge clk_host)
-    if (out_en)
-      out_r <= out_w;
+    if (rst_host) begin
+      cfg_busy_r       <= 'b0;
+      cfg_commit_tgl_r <= 'b0;
+      cfg_dirty_r      <= '0;
+      cfg_bank_r       <= '0;
+    end else begin
+      cfg_busy_r       <= cfg_busy_w;
+      cfg_commit_tgl_r <= cfg_commit_tgl_w;
+      cfg_dirty_r      <= cfg_dirty_w;
+      cfg_bank_r       <= cfg_bank_w;
+    end
 
   // ------------------------------------------------------------------------ //
   //
   always_ff @(posedge clk_host)
-    if (rst_host)
-      afifo_empty_r <= 'b1;
-    else
-      afifo_empty_r <= afifo_empty_w;
+    if (cfg_wr_en)
+      rule_mem_r [~cfg_bank_r [cfg_idx_w]][cfg_idx_w] <= cfg_entry_w;
   
   // ======================================================================== //
   //                                                                          //
@@ -579,6 +899,119 @@ module m (
   //                                                                          //
   // ======================================================================== //
 
+  // ------------------------------------------------------------------------ //
+  // Match logic; lane 0.
+  //
+  m_match #(.DEPTH(MATCH_DEPTH)) u_match_l0 (
+    //
+      .vld                    (l0_vld                  )
+    , .word                   (l0_word                 )
+    , .last                   (l0_last                 )
+    , .length                 (l0_length               )
+    , .word_off               (l0_word_off             )
+    //
+    , .op                     (l0_op                   )
+    //
+    , .type_found             (l0_type_found           )
+    , .symbol_found           (l0_symbol_found         )
+    , .symbol_buffer          (l0_symbol_buffer        )
+    , .symbol_slot            (l0_symbol_slot          )
+    //
+    , .en                     (net_en                  )
+    , .clk                    (clk_net                 )
+  );
+
+  // ------------------------------------------------------------------------ //
+  // Match logic; tail lane.
+  //
+  m_match #(.DEPTH(MATCH_DEPTH)) u_match_tl (
+    //
+      .vld                    (tail_vld_r              )
+    , .word                   (tl_word                 )
+    , .last                   ('b1                     )
+    , .length                 (tail_r.length           )
+    , .word_off               (tail_r.ctx.word_off     )
+    //
+    , .op                     (tail_r.ctx.op           )
+    //
+    , .type_found             (tl_type_found           )
+    , .symbol_found           (tl_symbol_found         )
+    , .symbol_buffer          (tl_symbol_buffer        )
+    , .symbol_slot            (tl_symbol_slot          )
+    //
+    , .en                     (net_en                  )
+    , .clk                    (clk_net                 )
+  );
+
+  // ------------------------------------------------------------------------ //
+  // Egress stage; forwards words to the host, or commits whole packets
+  // to the host according to their verdict.
+  //
+  m_egress #(.N(EGRESS_N)) u_egress (
+    //
+      .in_vld                 (out_vld_w               )
+    , .in                     (out_w                   )
+    , .in_ack                 (out_ack                 )
+    //
+    , .out_vld_r              (out_vld_r               )
+    , .out_r                  (out_r                   )
+    //
+    , .cfg                    (cfg_egress_w            )
+    //
+    , .overflows_r            (out_overflows_r         )
+    //
+    , .clk                    (clk_host                )
+    , .rst                    (rst_host                )
+  );
+
+  // ------------------------------------------------------------------------ //
+  // Completion engine; writes a descriptor for each packet delivered to
+  // the host.
+  //
+  m_cpl u_cpl (
+    //
+      .in_vld                 (out_vld_r               )
+    , .in                     (out_r                   )
+    //
+    , .cfg                    (cfg_cpl_w               )
+    //
+    , .cons                   (cpl_cons_w              )
+    , .rd_idx                 (cpl_rd_idx_w            )
+    , .rd_desc                (cpl_rd_desc_w           )
+    //
+    , .prod_r                 (cpl_prod_r              )
+    , .irq_r                  (cpl_irq_r               )
+    , .overflows_r            (cpl_overflows_r         )
+    //
+    , .clk                    (clk_host                )
+    , .rst                    (rst_host                )
+  );
+
+  // ------------------------------------------------------------------------ //
+  // Synchronize rule table commit request into the NET clock domain.
+  //
+  sync_ff #(.W(1)) u_sync_cfg_commit (
+    //
+      .clk               (clk_net                 )
+    , .rst               (rst_net                 )
+    //
+    , .d                 (cfg_commit_tgl_r        )
+    , .q                 (rule_commit_tgl_nsync   )
+  );
+
+  // ------------------------------------------------------------------------ //
+  // Synchronize rule table commit acknowledgement into the HOST clock
+  // domain.
+  //
+  sync_ff #(.W(1)) u_sync_cfg_ack (
+    //
+      .clk               (clk_host                )
+    , .rst               (rst_host                )
+    //
+    , .d                 (rule_ack_tgl_r          )
+    , .q                 (cfg_ack_tgl_hsync       )
+  );
+
   // ------------------------------------------------------------------------ //
   // Asynchronous queue to communciate packet data from the network
   // clock to the host clock. As host clock > network clock, and in
@@ -589,12 +1022,34 @@ module m (
   // "off-the-shelf" IP that can be easily generated in an FPGA
   // context.
   //
+  // Where packets are filtered or truncated (cfg_egress_w), the egress
+  // stage presents each packed word to its buffer on two successive
+  // cycles, and stalls the queue for a HOST cycle on each. The HOST
+  // clock must then be no slower than (1 + f) times the NET clock,
+  // where f is the fraction of words which are packed; that is, twice
+  // the NET clock where every word is packed.
+  //
   // Notes: the decision here was to perform the packet parsing in the
   // slower network clock-domain as there is potentially some small
   // (probably neglible) power saving to be had from performing this
   // on a slower clock.
   //
-  async_queue #(.W($bits(m_pkg::out_t)), .N(16)) u_async_queue (
+  // The data path carries every word; the verdict path carries the
+  // sideband (length and buffer) only on EOP, such that the sideband
+  // is not retained for every word in flight. An entry is pushed to
+  // the verdict path with each EOP word pushed to the data path, and
+  // popped with it, such that the verdict path never holds more
+  // entries than the data path. The verdict path is sized for packets
+  // of some words, not for the worst case of a single word per packet
+  // (every word EOP): where it fills, the NET pipeline stalls and the
+  // ingress refuses further words (in_rdy_w) until an entry has been
+  // popped (see: stall_PROC). Its depth (VFIFO_N) covers the round
+  // trip of the pointers across the clock-crossing, such that words
+  // of a single word per packet are refused only where the HOST clock
+  // is slower than the NET clock.
+  //
+  async_queue #(.W($bits(m_pkg::afifo_data_t)), .N(m_pkg::AFIFO_N))
+    u_async_queue (
     //
       .wclk                   (clk_net                 )
     , .wrst                   (rst_net                 )
@@ -609,9 +1064,30 @@ module m (
     , .pop_data               (afifo_pop_data          )
     //
     , .empty_w                (afifo_empty_w           )
-    // verilator lint_off PINCONNECTEMPTY
-    , .full_w                 ()
-    // verilator lint_on PINCONNECTEMPTY
+    , .full_w                 (afifo_full_w            )
+  );
+
+  // ------------------------------------------------------------------------ //
+  // Asynchronous queue to communicate the EOP sideband of each packet
+  // from the network clock to the host clock.
+  //
+  async_queue #(.W($bits(m_pkg::vfifo_data_t)), .N(m_pkg::VFIFO_N))
+    u_verdict_queue (
+    //
+      .wclk                   (clk_net                 )
+    , .wrst                   (rst_net                 )
+    //
+    , .rclk                   (clk_host                )
+    , .rrst                   (rst_host                )
+    //
+    , .push                   (vfifo_push              )
+    , .push_data              (vfifo_push_data         )
+    //
+    , .pop                    (vfifo_pop               )
+    , .pop_data               (vfifo_pop_data          )
+    //
+    , .empty_w                (vfifo_empty_w           )
+    , .full_w                 (vfifo_full_w            )
   );
 
 endmodule // m
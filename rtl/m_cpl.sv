@@ -0,0 +1,228 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`default_nettype none
+`timescale 1ns/1ps
+
+`include "m_pkg.vh"
+
+// Host completion engine. A descriptor is written to the completion
+// ring for each packet delivered to the host (on EOP), recording the
+// channel, the bytes delivered and the verdict of the packet. The
+// ring is consumed by the host, which returns descriptors by
+// advancing its consumer pointer ('cons').
+//
+// Notifications ('irq_r') are coalesced: a notification is raised once
+// 'cfg.count' descriptors are pending, or once the oldest pending
+// descriptor has waited 'cfg.timeout' cycles, whichever occurs first.
+// A notification is also raised whenever the ring is full, as no
+// further descriptor could otherwise be written.
+//
+// A descriptor which arrives to a full ring is discarded and counted
+// as an overflow; its sequence number is nonetheless consumed, such
+// that the loss is apparent to the host.
+//
+module m_cpl (
+
+  // ======================================================================== //
+  // Ingress (host egress stream)
+    input logic                                   in_vld
+  , input m_pkg::out_t                            in
+
+  // ======================================================================== //
+  // Configuration (static)
+  , input m_pkg::cpl_cfg_t                        cfg
+
+  // ======================================================================== //
+  // Ring
+  , input m_pkg::cpl_ptr_t                        cons
+  , input m_pkg::cpl_idx_t                        rd_idx
+  , output m_pkg::cpl_desc_t                      rd_desc
+  //
+  , output m_pkg::cpl_ptr_t                       prod_r
+  , output logic                                  irq_r
+
+  // ======================================================================== //
+  // Descriptors discarded on overflow
+  , output m_pkg::egress_count_t                  overflows_r
+
+  // ======================================================================== //
+  // Clk/Reset
+  , input                                         clk
+  , input                                         rst
+);
+
+  // ======================================================================== //
+  //                                                                          //
+  // Wires                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // Byte accounting:
+  logic                                 in_packed;
+  m_pkg::cpl_bytes_t [m_pkg::CHAN_N - 1:0] acc_r;
+  m_pkg::cpl_bytes_t [m_pkg::CHAN_N - 1:0] acc_w;
+  m_pkg::cpl_bytes_t                    bytes;
+
+  // Ring write:
+  logic                                 cpl_vld;
+  logic                                 full;
+  logic                                 mem_en;
+  m_pkg::cpl_desc_t                     mem_w;
+  m_pkg::cpl_desc_t                     mem_r [m_pkg::CPL_N];
+  m_pkg::cpl_ptr_t                      prod_w;
+  m_pkg::cpl_seq_t                      seq_r;
+  m_pkg::cpl_seq_t                      seq_w;
+  logic                                 overflow_en;
+
+  // Coalescing:
+  m_pkg::cpl_ptr_t                      pending_r;
+  m_pkg::cpl_ptr_t                      pending_w;
+  m_pkg::cpl_ptr_t                      pending_inc;
+  logic [15:0]                          timer_r;
+  logic [15:0]                          timer_w;
+  logic                                 irq_w;
+
+  // ======================================================================== //
+  //                                                                          //
+  // Combinatorial Logic                                                      //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : bytes_PROC
+
+    // A packed word ends the packet in progress and starts the next;
+    // otherwise, a word is the SOP, a middle word, or the EOP of the
+    // packet of its channel.
+    //
+    in_packed  = in.sop & in.eop & (in.sop_off > in.length);
+
+    acc_w      = acc_r;
+    bytes      = '0;
+    if (in_vld) begin
+      if (in.sop & (~in_packed)) begin
+        bytes  = 'd8 - m_pkg::cpl_bytes_t'(in.sop_off);
+        if (in.eop)
+          bytes  = m_pkg::cpl_bytes_t'(in.length) + 'd1
+                 - m_pkg::cpl_bytes_t'(in.sop_off);
+      end else if (in.eop) begin
+        bytes  = acc_r [in.chan] + m_pkg::cpl_bytes_t'(in.length) + 'd1;
+      end else begin
+        bytes  = acc_r [in.chan] + 'd8;
+      end
+
+      acc_w [in.chan]  = bytes;
+      if (in_packed)
+        acc_w [in.chan]  = 'd8 - m_pkg::cpl_bytes_t'(in.sop_off);
+    end
+
+  end // block: bytes_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : ring_PROC
+
+    cpl_vld      = in_vld & in.eop;
+    full         = ((prod_r - cons) == m_pkg::cpl_ptr_t'(m_pkg::CPL_N));
+
+    mem_en       = cpl_vld & (~full);
+    mem_w        = '{seq:seq_r, chan:in.chan, bytes:bytes, status:in.status,
+                     buffer:in.buffer};
+    overflow_en  = cpl_vld & full;
+
+    prod_w       = prod_r + (mem_en ? 'd1 : 'd0);
+    seq_w        = seq_r + (cpl_vld ? 'd1 : 'd0);
+
+    rd_desc      = mem_r [rd_idx];
+
+  end // block: ring_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : irq_PROC
+
+    // Descriptors pending notification, including that written on the
+    // current cycle.
+    //
+    pending_inc  = pending_r + (mem_en ? 'd1 : 'd0);
+
+    irq_w        =   (pending_inc != '0)
+                   & (   (16'(pending_inc) >= 16'(cfg.count))
+                       | ((cfg.timeout != '0) & (timer_r >= cfg.timeout))
+                       | ((prod_w - cons) == m_pkg::cpl_ptr_t'(m_pkg::CPL_N)));
+
+    // The timer measures the wait of the oldest pending descriptor.
+    //
+    pending_w    = irq_w ? '0 : pending_inc;
+    timer_w      = '0;
+    if ((~irq_w) & (pending_r != '0))
+      timer_w  = timer_r + 'd1;
+
+  end // block: irq_PROC
+
+  // ======================================================================== //
+  //                                                                          //
+  // Flops                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (rst) begin
+      acc_r     <= '0;
+      prod_r    <= '0;
+      seq_r     <= '0;
+      pending_r <= '0;
+      timer_r   <= '0;
+      irq_r     <= 'b0;
+    end else begin
+      acc_r     <= acc_w;
+      prod_r    <= prod_w;
+      seq_r     <= seq_w;
+      pending_r <= pending_w;
+      timer_r   <= timer_w;
+      irq_r     <= irq_w;
+    end
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (mem_en)
+      mem_r [prod_r [$clog2(m_pkg::CPL_N)-1:0]] <= mem_w;
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (rst)
+      overflows_r <= '0;
+    else if (overflow_en)
+      overflows_r <= overflows_r + 'd1;
+
+endmodule // m_cpl
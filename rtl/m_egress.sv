@@ -0,0 +1,373 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`default_nettype none
+`timescale 1ns/1ps
+
+`include "m_pkg.vh"
+
+// Host egress stage. In FORWARD mode, words are emitted to the host as
+// they are received. Otherwise, the words of each packet are retained
+// in a store-and-forward buffer until the verdict of the packet is
+// known (on EOP), whereupon the packet is committed to the host if it
+// matched and is otherwise discarded (FILTER) or truncated to its
+// initial words (TRUNCATE). The buffer is partitioned by channel, such
+// that the packets of interleaved channels are committed
+// independently; committed words are emitted in order within a
+// channel, and channels are arbitrated round-robin.
+//
+// A packed word (ending one packet and starting the next) is presented
+// to the buffer as two words on successive cycles, the final word of
+// the packet in progress and then the initial word of the next, as the
+// two packets may differ in outcome. The ingress is stalled ('in_ack'
+// deasserted) on the first of the two.
+//
+// A packet which does not fit in the buffer of its channel is
+// discarded in its entirety, irrespective of its verdict, and is
+// counted as an overflow.
+//
+module m_egress #(
+    // Capacity (in words) of the buffer of each channel; a power of two.
+    parameter int N = m_pkg::EGRESS_N
+) (
+
+  // ======================================================================== //
+  // Ingress
+    input logic                                   in_vld
+  , input m_pkg::out_t                            in
+  , output logic                                  in_ack
+
+  // ======================================================================== //
+  // Egress
+  , output logic                                  out_vld_r
+  , output m_pkg::out_t                           out_r
+
+  // ======================================================================== //
+  // Configuration (static)
+  , input m_pkg::egress_cfg_t                     cfg
+
+  // ======================================================================== //
+  // Packets discarded on overflow
+  , output m_pkg::egress_count_t                  overflows_r
+
+  // ======================================================================== //
+  // Clk/Reset
+  , input                                         clk
+  , input                                         rst
+);
+
+  // ======================================================================== //
+  //                                                                          //
+  // Types                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  typedef struct packed {
+    logic                 x;
+    logic [$clog2(N)-1:0] a;
+  } ptr_t;
+
+  // Buffer entry; the EOP sideband is retained apart from the word
+  // such that it may be rewritten on truncation.
+  typedef struct packed {
+    logic                      sop;
+    m_pkg::len_t               sop_off;
+    m_pkg::data_t              data;
+  } buf_data_t;
+
+  typedef struct packed {
+    logic                      eop;
+    m_pkg::len_t               length;
+    m_pkg::status_t            status;
+    m_pkg::buffer_t            buffer;
+  } buf_side_t;
+
+  // ======================================================================== //
+  //                                                                          //
+  // Wires                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // Ingress:
+  logic                                 filter;
+  logic                                 in_packed;
+  logic                                 split_r;
+  logic                                 split_w;
+
+  // Buffer write:
+  logic                                 wr_vld;
+  m_pkg::out_t                          wr;
+  ptr_t                                 wr_base;
+  logic                                 wr_drop;
+  logic                                 wr_full;
+  logic                                 wr_hit;
+  logic [$clog2(N):0]                   wr_occupancy;
+  logic [$clog2(N):0]                   wr_words;
+  logic [$clog2(N):0]                   wr_keep;
+
+  // Per-channel buffer state; words in [rd, start) are committed,
+  // words in [start, wr) belong to the packet in progress.
+  ptr_t [m_pkg::CHAN_N - 1:0]           rd_ptr_r;
+  ptr_t [m_pkg::CHAN_N - 1:0]           rd_ptr_w;
+  ptr_t [m_pkg::CHAN_N - 1:0]           start_ptr_r;
+  ptr_t [m_pkg::CHAN_N - 1:0]           start_ptr_w;
+  ptr_t [m_pkg::CHAN_N - 1:0]           wr_ptr_r;
+  ptr_t [m_pkg::CHAN_N - 1:0]           wr_ptr_w;
+  // Packet in progress has overflowed; discard until the next SOP.
+  logic [m_pkg::CHAN_N - 1:0]           drop_r;
+  logic [m_pkg::CHAN_N - 1:0]           drop_w;
+
+  // Buffer:
+  logic                                 data_mem_en;
+  buf_data_t                            data_mem_w;
+  buf_data_t                            data_mem_r [m_pkg::CHAN_N][N];
+  logic                                 side_mem_en;
+  ptr_t                                 side_mem_addr;
+  buf_side_t                            side_mem_w;
+  buf_side_t                            side_mem_r [m_pkg::CHAN_N][N];
+
+  // Buffer read:
+  logic [m_pkg::CHAN_N - 1:0]           rd_req;
+  logic                                 rd_vld;
+  m_pkg::chan_t                         rd_chan;
+  m_pkg::chan_t                         rd_rr_r;
+  m_pkg::chan_t                         rd_rr_w;
+
+  // Overflow accounting:
+  logic                                 overflow_en;
+
+  // Output flops:
+  logic                                 out_vld_w;
+  m_pkg::out_t                          out_w;
+
+  // ======================================================================== //
+  //                                                                          //
+  // Combinatorial Logic                                                      //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : in_PROC
+
+    filter     = (cfg.mode != m_pkg::EGRESS_FORWARD);
+    in_packed  = in.sop & in.eop & (in.sop_off > in.length);
+
+    // Present a packed word as the final word of the packet in
+    // progress, then as the initial word of the next packet.
+    //
+    wr         = in;
+    if (in_packed) begin
+      if (~split_r) begin
+        wr.sop     = 'b0;
+      end else begin
+        wr.eop     = 'b0;
+        wr.length  = '0;
+        wr.status  = '0;
+        wr.buffer  = '0;
+      end
+    end
+
+    wr_vld     = in_vld & filter;
+    split_w    = wr_vld & in_packed & (~split_r);
+
+    // Retain a packed word on the ingress until its second half has
+    // been presented.
+    //
+    in_ack     = (~split_w);
+
+  end // block: in_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : wr_PROC
+
+    // An SOP discards the incomplete packet in progress (if any).
+    //
+    wr_base       = wr.sop ? start_ptr_r [wr.chan] : wr_ptr_r [wr.chan];
+    wr_drop       = (~wr.sop) & drop_r [wr.chan];
+    wr_occupancy  = wr_base - rd_ptr_r [wr.chan];
+    wr_full       =   (wr_occupancy == ($clog2(N) + 1)'(N))
+                    | (m_pkg::egress_depth_t'(wr_occupancy) >= cfg.depth);
+
+    // Words of the packet in progress, including the current word, and
+    // the words retained should the packet not match.
+    //
+    wr_words      = wr_base - start_ptr_r [wr.chan] + 'd1;
+    wr_keep       = '0;
+    if (cfg.mode == m_pkg::EGRESS_TRUNCATE)
+      wr_keep  = ($clog2(N) + 1)'(cfg.hdr);
+    wr_hit        = (wr.buffer != '0) | (wr_words <= wr_keep);
+
+    rd_ptr_w      = rd_ptr_r;
+    start_ptr_w   = start_ptr_r;
+    wr_ptr_w      = wr_ptr_r;
+    drop_w        = drop_r;
+    overflow_en   = 'b0;
+
+    data_mem_en   = 'b0;
+    data_mem_w    = '{sop:wr.sop, sop_off:wr.sop_off, data:wr.data};
+    side_mem_en   = 'b0;
+    side_mem_addr = wr_base;
+    side_mem_w    = '{eop:wr.eop, length:wr.length, status:wr.status,
+                      buffer:wr.buffer};
+
+    if (wr_vld) begin
+      wr_ptr_w [wr.chan]  = wr_base;
+      drop_w [wr.chan]    = wr_drop;
+
+      if (wr_drop) begin
+        // Discard the remainder of an overflowed packet.
+      end else if (wr_full) begin
+        // Discard the packet in progress.
+        wr_ptr_w [wr.chan]  = start_ptr_r [wr.chan];
+        drop_w [wr.chan]    = 'b1;
+        overflow_en         = 'b1;
+      end else begin
+        data_mem_en         = 'b1;
+        side_mem_en         = 'b1;
+        wr_ptr_w [wr.chan]  = wr_base + 'd1;
+
+        if (wr.eop) begin
+          if (wr_hit) begin
+            // Commit packet.
+            start_ptr_w [wr.chan]  = wr_base + 'd1;
+          end else if (wr_keep != '0) begin
+            // Commit the initial words of the packet; the final
+            // retained word is rewritten to end the packet (retaining
+            // the status of the packet).
+            side_mem_addr          = start_ptr_r [wr.chan] + wr_keep - 'd1;
+            side_mem_w             = '{eop:'b1, length:'1, status:wr.status,
+                                       buffer:'0};
+            start_ptr_w [wr.chan]  = start_ptr_r [wr.chan] + wr_keep;
+            wr_ptr_w [wr.chan]     = start_ptr_r [wr.chan] + wr_keep;
+          end else begin
+            // Discard packet.
+            wr_ptr_w [wr.chan]     = start_ptr_r [wr.chan];
+          end
+        end
+      end
+    end
+
+    // Arbitrate amongst the channels with committed words, starting
+    // from the channel following that last emitted.
+    //
+    for (int c = 0; c < m_pkg::CHAN_N; c++)
+      rd_req [c]  = (rd_ptr_r [c] != start_ptr_r [c]);
+
+    rd_vld   = filter & (rd_req != '0);
+    rd_chan  = rd_rr_r;
+    for (int i = m_pkg::CHAN_N - 1; i >= 0; i--)
+      if (rd_req [m_pkg::chan_t'(rd_rr_r + i)])
+        rd_chan  = m_pkg::chan_t'(rd_rr_r + i);
+
+    rd_rr_w  = rd_chan + 'd1;
+    if (rd_vld)
+      rd_ptr_w [rd_chan]  = rd_ptr_r [rd_chan] + 'd1;
+
+  end // block: wr_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : out_PROC
+
+    if (filter) begin
+      out_vld_w     = rd_vld;
+      out_w         = '0;
+      out_w.chan    = rd_chan;
+      {out_w.sop, out_w.sop_off, out_w.data} =
+        data_mem_r [rd_chan][rd_ptr_r [rd_chan].a];
+      {out_w.eop, out_w.length, out_w.status, out_w.buffer} =
+        side_mem_r [rd_chan][rd_ptr_r [rd_chan].a];
+    end else begin
+      out_vld_w     = in_vld;
+      out_w         = in;
+    end
+
+  end // block: out_PROC
+
+  // ======================================================================== //
+  //                                                                          //
+  // Flops                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (rst) begin
+      split_r     <= 'b0;
+      rd_ptr_r    <= '0;
+      start_ptr_r <= '0;
+      wr_ptr_r    <= '0;
+      drop_r      <= '0;
+      rd_rr_r     <= '0;
+    end else begin
+      split_r     <= split_w;
+      rd_ptr_r    <= rd_ptr_w;
+      start_ptr_r <= start_ptr_w;
+      wr_ptr_r    <= wr_ptr_w;
+      drop_r      <= drop_w;
+      if (rd_vld)
+        rd_rr_r   <= rd_rr_w;
+    end
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (data_mem_en)
+      data_mem_r [wr.chan][wr_base.a] <= data_mem_w;
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (side_mem_en)
+      side_mem_r [wr.chan][side_mem_addr.a] <= side_mem_w;
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (rst)
+      overflows_r <= '0;
+    else if (overflow_en)
+      overflows_r <= overflows_r + 'd1;
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (rst)
+      out_vld_r <= 'b0;
+    else
+      out_vld_r <= out_vld_w;
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk)
+    if (out_vld_w)
+      out_r <= out_w;
+
+endmodule // m_egress
@@ -0,0 +1,292 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`default_nettype none
+`timescale 1ns/1ps
+
+`include "m_pkg.vh"
+
+// Match logic applied to a single 8B word of a packet. The word is
+// presented realigned to the packet (byte 0 of the word is byte
+// (8 * word_off) of the packet) such that matching is independent of
+// the alignment of the packet on the ingress.
+//
+// The match is carried out in three steps: byte-equality vectors are
+// computed for every candidate location of the type and symbols, the
+// vectors are reduced to a per-location outcome, and the outcomes are
+// selected and prioritized. A register may be placed after each of
+// the first two steps (DEPTH <= 2), such that the result is presented
+// DEPTH cycles after the word.
+//
+module m_match #(
+    parameter int DEPTH = 0
+) (
+
+  // ======================================================================== //
+  // Word
+    input logic                                   vld
+  , input m_pkg::data_t                           word
+  // Word is the final word of the packet.
+  , input logic                                   last
+  // Byte offset of the final valid byte (when 'last').
+  , input m_pkg::len_t                            length
+  // Word offset within the packet.
+  , input m_pkg::packet_word_off_t                word_off
+
+  // ======================================================================== //
+  // Oprands
+  , input m_pkg::rule_entry_t                     op
+
+  // ======================================================================== //
+  // Result (DEPTH cycles after the word)
+  , output logic                                  type_found
+  , output logic                                  symbol_found
+  , output m_pkg::buffer_t                        symbol_buffer
+  , output m_pkg::sym_slot_t                      symbol_slot
+
+  // ======================================================================== //
+  // Clk; the registered steps advance only where 'en' (both unused
+  // where DEPTH == 0).
+  // verilator lint_off UNUSED
+  , input                                         en
+  , input                                         clk
+  // verilator lint_on UNUSED
+);
+
+  // ======================================================================== //
+  //                                                                          //
+  // Types                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // Byte-equality vectors.
+  typedef struct packed {
+    // Type is expected within the word, at a permissible offset.
+    logic                       type_sel;
+    logic [2:0]                 type_off;
+    // Byte 'j' of the type equals byte 'i + j' of the word.
+    logic [4:0][3:0]            type_eq;
+    // Symbol may match within the word.
+    logic [3:0]                 sym_sel;
+    // Byte 'j' of symbol 'i' equals byte 'j' of the word.
+    logic [3:0][7:0]            sym_eq;
+    m_pkg::buffer_t [3:0]       sym_buffer;
+  } eq_t;
+
+  // Per-location outcome.
+  typedef struct packed {
+    logic                       type_sel;
+    logic [2:0]                 type_off;
+    // Type found at byte offset 'i' of the word.
+    logic [4:0]                 type_pos;
+    // Symbol 'i' found in the word.
+    logic [3:0]                 sym_hit;
+    m_pkg::buffer_t [3:0]       sym_buffer;
+  } red_t;
+
+  // ======================================================================== //
+  //                                                                          //
+  // Wires                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // eq_PROC
+  logic [7:0]                           match_valid_mask;
+  logic                                 match_symbol_bloom_hit;
+  logic                                 match_symbol_can_match_word;
+  eq_t                                  eq_w;
+  // Registered where DEPTH >= 1.
+  eq_t                                  eq_r;
+
+  // red_PROC
+  red_t                                 red_w;
+  // Registered where DEPTH >= 2.
+  red_t                                 red_r;
+
+  // ======================================================================== //
+  //                                                                          //
+  // Comb.                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  // Type is a 4B quantity which is constrained to fall within a
+  // single 8B word. The type field may not straddle multiple
+  // words. Therefore, the type field may be aligned to the following
+  // locations within the word:
+  //
+  //   [3:0], [4:1], [5:2], [6:3], [7:4]
+  //
+  // Locations:
+  //
+  //   [<=2:A] and [B:>=5]
+  //
+  // are impermissible and are therefore ingored.
+  //
+  // Caveat: The problem statement makes no explicit reference to the
+  // expected alignment of the 'symbol'. As the type is constrained
+  // such that it may not straddle multiple 8B words, it is too
+  // assumed that this remains the case for symbols.
+  //
+  always_comb begin : eq_PROC
+
+    // Mask denoting the valid bytes within the current word. Length
+    // is only considered on the final word.
+    //
+    match_valid_mask   = m_pkg::len_to_unary_mask(length) | {8{~last}};
+
+    // The type is expected somewhere within the current word, at one
+    // of the permissible starting locations: 0, 1, 2, 3, 4 (as above).
+    //
+    eq_w               = '0;
+    eq_w.type_sel      = vld & (word_off == op.rule.type_off.word) &
+                         (op.rule.type_off.off <= 'd4);
+    eq_w.type_off      = op.rule.type_off.off;
+
+    // Byte comparison logic for each of the valid matching regions.
+    //
+    for (int i = 0; i < 5; i++)
+      for (int j = 0; j < 4; j++)
+        eq_w.type_eq [i][j]  =
+          match_valid_mask [i + j] & (op.rule.type [j] == word [i + j]);
+
+    // A symbol is 8B therefore a match can occur only when the entire
+    // 8B word is valid.
+    //
+    match_symbol_can_match_word  = (~last) | (length == 'd7);
+
+    // When symbols may be placed anywhere in the payload, each word
+    // is first tested against a Bloom filter of the symbol set. The
+    // exact comparison is carried out only upon a filter hit, which
+    // may be a false-positive, but never a false-negative.
+    //
+    match_symbol_bloom_hit  =
+      op.bloom [m_pkg::bloom_h0(word)] & op.bloom [m_pkg::bloom_h1(word)];
+
+    // Each match entity contains a specific SYMBOL_OFFSET value which
+    // denotes the word in which the match operation can take
+    // place. The match is not attempted it the current word is not at
+    // the required location. Caveat: I have added an additional valid
+    // field to the structure such that the match will not take place
+    // unless the value has been appropriately configured. The offset
+    // is disregarded when the symbols may be placed anywhere.
+    //
+    for (int i = 0; i < 4; i++) begin
+      eq_w.sym_sel [i]     =
+        vld & match_symbol_can_match_word & op.rule.symbol [i].valid &
+         (op.rule.sym_anywhere ? match_symbol_bloom_hit
+                               : (word_off == op.rule.symbol [i].off));
+      for (int j = 0; j < 8; j++)
+        eq_w.sym_eq [i][j]  = (op.rule.symbol [i].match [j] == word [j]);
+      eq_w.sym_buffer [i]  = op.rule.symbol [i].buffer;
+    end
+
+  end // block: eq_PROC
+
+  // ------------------------------------------------------------------------ //
+  // Reduce byte-equality vectors to the outcome at each location.
+  //
+  always_comb begin : red_PROC
+
+    red_w             = '0;
+    red_w.type_sel    = eq_r.type_sel;
+    red_w.type_off    = eq_r.type_off;
+    for (int i = 0; i < 5; i++)
+      red_w.type_pos [i]  = (&eq_r.type_eq [i]);
+    for (int i = 0; i < 4; i++)
+      red_w.sym_hit [i]   = eq_r.sym_sel [i] & (&eq_r.sym_eq [i]);
+    red_w.sym_buffer  = eq_r.sym_buffer;
+
+  end // block: red_PROC
+
+  // ------------------------------------------------------------------------ //
+  // Select the type outcome at the nominated location, and prioritize
+  // symbol outcomes.
+  //
+  always_comb begin : sel_PROC
+
+    type_found     = red_r.type_sel & red_r.type_pos [red_r.type_off];
+
+    // Flag denoting when a match occurred in the current word (an
+    // explicit flag is necessary here as if this detection was only
+    // carried out on the "_buffer" value when non-zero, the logic
+    // could not detect the buffer == '0 case).
+    //
+    symbol_found   = (|red_r.sym_hit);
+
+    // Note: this is a 4-Way priority decoded structure. The problem
+    // statement does not specifically reference what to do whenever
+    // multiple matches occur in the same cycle. It would be assumed
+    // that this case would represent a misconfigured system which
+    // would not occur in practice, however to prevent corruption on
+    // the key, the code simply selects the highest endian match.
+    //
+    symbol_buffer  = '0;
+    symbol_slot    = '0;
+    for (int i = 0; i < 4; i++)
+      if (red_r.sym_hit [i]) begin
+        symbol_buffer  = red_r.sym_buffer [i];
+        symbol_slot    = m_pkg::sym_slot_t'(i);
+      end
+
+  end // block: sel_PROC
+
+  // ======================================================================== //
+  //                                                                          //
+  // Flops                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  //
+  if (DEPTH >= 1) begin : g_eq_r
+
+    always_ff @(posedge clk)
+      if (en)
+        eq_r <= eq_w;
+
+  end else begin : g_eq_w
+
+    always_comb eq_r  = eq_w;
+
+  end
+
+  // ------------------------------------------------------------------------ //
+  //
+  if (DEPTH >= 2) begin : g_red_r
+
+    always_ff @(posedge clk)
+      if (en)
+        red_r <= red_w;
+
+  end else begin : g_red_w
+
+    always_comb red_r  = red_w;
+
+  end
+
+endmodule // m_match
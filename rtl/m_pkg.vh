@@ -42,10 +42,39 @@ package m_pkg;
   // Data type
   typedef logic [7:0][7:0] data_t;
 
+  // Number of rule sets retained in the rule table.
+  localparam int RULE_N = 8;
+
+  // Rule set index type
+  typedef logic [$clog2(RULE_N)-1:0] rule_idx_t;
+
+  // Number of logical channels interleaved on the ingress.
+  localparam int CHAN_N = 4;
+
+  // Channel identifier type
+  typedef logic [$clog2(CHAN_N)-1:0] chan_t;
+
   // Input packet type
+  //
+  // A word may end one packet and start the next (a "packed" word),
+  // in which case the packet in progress ends at byte 'length' and
+  // the next packet starts at byte 'sop_off' (sop_off > length).
+  // Otherwise, a packet starts at byte 'sop_off' on SOP and ends at
+  // byte 'length' on EOP.
+  //
+  // Packets on distinct channels may be interleaved word by word; the
+  // words of a packet are those of its channel.
+  //
   typedef struct packed {
+    // Channel
+    chan_t       chan;
+    // Rule set index (sampled on SOP)
+    rule_idx_t   rule;
     logic        sop;
     logic        eop;
+    // Byte offset of SOP within word
+    len_t        sop_off;
+    // Byte offset of EOP within word
     len_t        length;
     data_t       data;
   } in_t;
@@ -53,15 +82,54 @@ package m_pkg;
   // "Buffer" match token type
   typedef logic [7:0] buffer_t;
 
-  // Output packet type
+  // Symbol slot type; the index of a symbol within a rule set.
+  typedef logic [1:0] sym_slot_t;
+
+  // Match status of a packet.
   typedef struct packed {
+    // Packet type found.
+    logic        type_hit;
+    // Packet type and a symbol found; the packet matched.
+    logic        hit;
+    // Slot of the matching symbol (when 'hit').
+    sym_slot_t   slot;
+  } status_t;
+
+  // Output packet type (as in_t; 'status' and 'buffer' correspond to
+  // the packet ending in the word on EOP).
+  typedef struct packed {
+    chan_t       chan;
     logic        sop;
     logic        eop;
+    len_t        sop_off;
     len_t        length;
     data_t       data;
+    status_t     status;
     buffer_t     buffer;
   } out_t;
 
+  // Depth of the NET to HOST clock-crossing queues; data path and
+  // verdict path (see: m).
+  localparam int AFIFO_N = 16;
+  localparam int VFIFO_N = 8;
+
+  // Clock-crossing data path entry; every word.
+  typedef struct packed {
+    chan_t       chan;
+    logic        sop;
+    logic        eop;
+    len_t        sop_off;
+    data_t       data;
+  } afifo_data_t;
+
+  // Clock-crossing verdict path entry; the EOP sideband of each
+  // packet (meaningful only on EOP).
+  typedef struct packed {
+    len_t        length;
+    status_t     status;
+    buffer_t     buffer;
+  } vfifo_data_t;
+
   // Packet type, type.
   typedef logic [3:0][7:0] packet_type_t;
 
@@ -85,6 +153,127 @@ package m_pkg;
     logic [2:0]         off;
   } packet_off_t;
 
+  // Rule set; the match criteria applied to a packet.
+  typedef struct packed {
+    // Packet type location
+    packet_off_t        type_off;
+    // Packet type
+    packet_type_t       type;
+    // Symbols are matched against every payload word, irrespective
+    // of their word offset.
+    logic               sym_anywhere;
+    // Symbol matches
+    sym_match_t [3:0]   symbol;
+  } rule_t;
+
+  // Symbol Bloom-filter width (bits).
+  localparam int BLOOM_W = 64;
+
+  // Symbol Bloom-filter type
+  typedef logic [BLOOM_W-1:0] bloom_t;
+
+  // Symbol Bloom-filter index type
+  typedef logic [$clog2(BLOOM_W)-1:0] bloom_idx_t;
+
+  // Bloom-filter hash functions; each is a simple XOR fold of the
+  // word (the second rotates each byte by its byte index prior to the
+  // fold) and is therefore cheap to compute at line rate.
+  function bloom_idx_t bloom_h0(data_t d); begin
+    logic [63:0] w;
+    w         = d;
+    bloom_h0  = '0;
+    for (int i = 0; i < 64; i++)
+      bloom_h0 [i % 6] ^= w [i];
+  end endfunction
+
+  function bloom_idx_t bloom_h1(data_t d); begin
+    logic [63:0] w;
+    w         = d;
+    bloom_h1  = '0;
+    for (int i = 0; i < 64; i++)
+      bloom_h1 [(i + (i / 8)) % 6] ^= w [i];
+  end endfunction
+
+  // Rule table entry; the rule set and the Bloom filter derived from
+  // its symbols on configuration.
+  typedef struct packed {
+    rule_t              rule;
+    bloom_t             bloom;
+  } rule_entry_t;
+
+  // Maximum depth of the match pipeline; the number of register
+  // stages between presentation of a word to the match logic and its
+  // outcome.
+  localparam int MATCH_DEPTH_MAX = 2;
+
+  // Egress mode (see: m_egress)
+  typedef enum logic [1:0] {
+    // Every word is forwarded to the host as it is received.
+    EGRESS_FORWARD  = 2'b00,
+    // Packets which do not match are discarded.
+    EGRESS_FILTER   = 2'b01,
+    // Packets which do not match are truncated to their initial words.
+    EGRESS_TRUNCATE = 2'b10
+  } egress_mode_t;
+
+  // Default capacity (in words) of the egress buffer of each channel.
+  localparam int EGRESS_N = 256;
+
+  // Egress buffer occupancy type
+  typedef logic [15:0] egress_depth_t;
+
+  // Egress event counter type
+  typedef logic [31:0] egress_count_t;
+
+  // Egress configuration (static)
+  typedef struct packed {
+    egress_mode_t       mode;
+    // Words retained of a packet which did not match (TRUNCATE); a
+    // packet of no more words is delivered whole.
+    packet_word_off_t   hdr;
+    // Words of the buffer of each channel available to packets;
+    // [1, EGRESS_N].
+    egress_depth_t      depth;
+  } egress_cfg_t;
+
+  // Number of descriptors retained by the completion ring.
+  localparam int CPL_N = 64;
+
+  // Completion ring index type
+  typedef logic [$clog2(CPL_N)-1:0] cpl_idx_t;
+
+  // Completion ring pointer type; carries an additional wrap bit.
+  typedef logic [$clog2(CPL_N):0] cpl_ptr_t;
+
+  // Completion sequence number type
+  typedef logic [15:0] cpl_seq_t;
+
+  // Packet byte count type
+  typedef logic [15:0] cpl_bytes_t;
+
+  // Completion descriptor; one per packet delivered to the host (see:
+  // m_cpl).
+  typedef struct packed {
+    // Sequence number; consecutive across descriptors, such that a
+    // descriptor lost on overflow of the ring is apparent.
+    cpl_seq_t           seq;
+    chan_t              chan;
+    // Bytes of the packet delivered (modulo 2^16).
+    cpl_bytes_t         bytes;
+    status_t            status;
+    buffer_t            buffer;
+  } cpl_desc_t;
+
+  // Completion configuration (static)
+  typedef struct packed {
+    // Descriptors pending before a notification is raised; 0 or 1
+    // raises a notification on every descriptor.
+    logic [7:0]         count;
+    // Cycles after which pending descriptors are notified, irrespective
+    // of 'count'; 0 disables the timeout.
+    logic [15:0]        timeout;
+  } cpl_cfg_t;
+
 endpackage // m_pkg
 
 `endif
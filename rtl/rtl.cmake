@@ -34,12 +34,13 @@ set(RTL_SOURCES
   "${RTL_ROOT}/common/gray_decode.sv"
   "${RTL_ROOT}/common/gray_encode.sv"
   "${RTL_ROOT}/common/sync_ff.sv"
+  "${RTL_ROOT}/m_cpl.sv"
+  "${RTL_ROOT}/m_egress.sv"
+  "${RTL_ROOT}/m_match.sv"
   "${RTL_ROOT}/m.sv"
   )
 
 set(RTL_INCLUDE_PATHS
   "${RTL_ROOT}/common"
   "${RTL_ROOT}"
-  )
-
-set(RTL_CFG_SOURCES "${RTL_ROOT}/cfg.vlt")
\ No newline at end of file
+  )
\ No newline at end of file
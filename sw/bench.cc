@@ -0,0 +1,169 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "matcher.h"
+#include "traffic.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+
+// Throughput benchmark of the software matcher across the supported
+// kernels and thread counts. Verdicts of each kernel are checked
+// against those of the scalar kernel; exits non-zero on mismatch.
+//
+// Usage: matcher_bench [packets] [profile[:hit=ratio]]
+
+namespace {
+
+struct Workload {
+  std::vector<m::Rule> rules;
+  std::vector<std::uint8_t> data;
+  std::vector<m::Packet> pkts;
+  std::size_t bytes = 0;
+};
+
+// Number of rule sets; flows share rule sets.
+constexpr std::size_t RULE_N = 64;
+
+// Packets drawn from traffic profile 'profile' against rule sets of
+// which half match symbols anywhere within the packet. The type and
+// a symbol of the rule set are planted within a packet in the
+// proportion given by the profile hit-ratio.
+Workload build(std::size_t n, m::traffic::Profile& profile, unsigned seed) {
+  m::traffic::Rng mt(seed);
+  auto uniform = [&](std::size_t lo, std::size_t hi) {
+    return std::uniform_int_distribution<std::size_t>(lo, hi)(mt);
+  };
+
+  Workload w;
+  for (std::size_t i = 0; i < RULE_N; i++) {
+    m::Rule r;
+    r.type_off = uniform(0, 4);
+    r.type = static_cast<std::uint32_t>(mt());
+    r.symbol_anywhere = (i % 2) != 0;
+    for (m::Symbol& s : r.symbol) {
+      s.valid = true;
+      s.off = static_cast<std::uint8_t>(uniform(1, 7));
+      s.match = (static_cast<std::uint64_t>(mt()) << 32) | mt();
+      s.buffer = static_cast<std::uint8_t>(uniform(1, 255));
+    }
+    w.rules.push_back(r);
+  }
+
+  std::vector<std::size_t> len(n);
+  std::size_t total = 0;
+  for (std::size_t& l : len) {
+    l = profile.length->draw(mt);
+    total += l;
+  }
+  w.data.resize(total);
+  for (std::uint8_t& b : w.data) { b = static_cast<std::uint8_t>(mt()); }
+
+  std::bernoulli_distribution hit(profile.hit_ratio);
+  std::size_t off = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    std::uint8_t* d = w.data.data() + off;
+
+    m::Packet p;
+    p.data = d;
+    p.bytes = len[i];
+    p.rule = profile.flow->draw(mt) % RULE_N;
+    w.pkts.push_back(p);
+    off += len[i];
+
+    if (!hit(mt)) continue;
+
+    // The type and symbol are planted where the packet accommodates
+    // them; shorter packets are delivered as drawn, and miss.
+    const m::Rule& r{w.rules[p.rule]};
+    if ((r.type_off + sizeof(r.type)) <= p.bytes) {
+      std::memcpy(d + r.type_off, &r.type, sizeof(r.type));
+    }
+    const m::Symbol& s{r.symbol[uniform(0, 3)]};
+    const std::size_t words = p.bytes / 8;
+    if (words < 2) continue;
+    const std::size_t at = r.symbol_anywhere ? uniform(1, words - 1) : s.off;
+    if (at < words) { std::memcpy(d + at * 8, &s.match, sizeof(s.match)); }
+  }
+  w.bytes = total;
+  return w;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  const std::string name = (argc > 2) ? argv[2] : "imix";
+
+  std::unique_ptr<m::traffic::Profile> profile = m::traffic::make_profile(name);
+  if (!profile) {
+    std::cerr << "Unknown traffic profile: " << name << " (profiles:";
+    for (const std::string& p : m::traffic::profile_names()) {
+      std::cerr << " " << p;
+    }
+    std::cerr << "; overrides: :hit=<ratio>)\n";
+    return EXIT_FAILURE;
+  }
+  const Workload w = build(n, *profile, 1);
+
+  std::vector<std::uint8_t> expected(n);
+  m::Matcher(m::Isa::Scalar).match(w.rules, w.pkts.data(), n, expected.data());
+
+  std::size_t matched = 0;
+  for (std::uint8_t v : expected) { matched += (v != 0); }
+  std::cout << "profile:" << name << " packets:" << n << " bytes:" << w.bytes
+            << " matched:" << matched << "\n";
+
+  const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  int ret = EXIT_SUCCESS;
+  for (m::Isa isa : {m::Isa::Scalar, m::Isa::Avx2, m::Isa::Avx512}) {
+    if (!m::supported(isa)) {
+      std::cout << m::to_string(isa) << ": unsupported\n";
+      continue;
+    }
+    for (std::size_t threads = 1; ; threads = std::min(threads * 2, hw)) {
+      const m::Matcher matcher(isa, threads);
+      std::vector<std::uint8_t> actual(n);
+
+      const auto start = std::chrono::steady_clock::now();
+      matcher.match(w.rules, w.pkts.data(), n, actual.data());
+      const std::chrono::duration<double> dur =
+          std::chrono::steady_clock::now() - start;
+
+      const bool ok = (actual == expected);
+      if (!ok) { ret = EXIT_FAILURE; }
+      std::cout << m::to_string(isa) << " threads:" << threads
+                << " gbps:" << ((w.bytes * 8) / dur.count() / 1e9)
+                << (ok ? "" : " MISMATCH") << "\n";
+      if (threads == hw) break;
+    }
+  }
+  return ret;
+}
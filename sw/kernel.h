@@ -0,0 +1,61 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_SW_KERNEL_H
+#define M_SW_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace m::kernel {
+
+// Load the 8B (little-endian) word at byte offset 'off'.
+inline std::uint64_t load(const std::uint8_t* data, std::size_t off) {
+  std::uint64_t w;
+  std::memcpy(&w, data + off, sizeof(w));
+  return w;
+}
+
+// Scan kernels; each returns the index of the final word in [0, n)
+// equal to any of the 'k' words in 'sym', or 'n' if none. The scan
+// proceeds from the end of the packet as the final match in the
+// packet takes priority.
+std::size_t scan_scalar(const std::uint8_t* data, std::size_t n,
+                        const std::uint64_t* sym, std::size_t k);
+#ifdef M_SW_HAVE_AVX2
+std::size_t scan_avx2(const std::uint8_t* data, std::size_t n,
+                      const std::uint64_t* sym, std::size_t k);
+#endif
+#ifdef M_SW_HAVE_AVX512
+std::size_t scan_avx512(const std::uint8_t* data, std::size_t n,
+                        const std::uint64_t* sym, std::size_t k);
+#endif
+
+} // namespace m::kernel
+
+#endif
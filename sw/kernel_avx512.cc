@@ -0,0 +1,56 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "kernel.h"
+#include <immintrin.h>
+
+namespace m::kernel {
+
+std::size_t scan_avx512(const std::uint8_t* data, std::size_t n,
+                        const std::uint64_t* sym, std::size_t k) {
+  __m512i s[4];
+  for (std::size_t j = 0; j < k; j++) {
+    s[j] = _mm512_set1_epi64(static_cast<long long>(sym[j]));
+  }
+
+  // Compare 8 words per iteration against each symbol.
+  std::size_t i = n;
+  for (; i >= 8; i -= 8) {
+    const __m512i w = _mm512_loadu_si512(data + (i - 8) * 8);
+    __mmask8 mask = 0;
+    for (std::size_t j = 0; j < k; j++) {
+      mask |= _mm512_cmpeq_epi64_mask(w, s[j]);
+    }
+    if (mask != 0) return (i - 8) + (31 - __builtin_clz(mask));
+  }
+
+  // Remaining words at the head of the packet.
+  const std::size_t r = scan_scalar(data, i, sym, k);
+  return (r == i) ? n : r;
+}
+
+} // namespace m::kernel
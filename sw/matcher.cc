@@ -0,0 +1,205 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "matcher.h"
+#include "kernel.h"
+#include <algorithm>
+#include <thread>
+
+namespace m {
+
+namespace {
+
+// Word offsets are retained by the RTL as 8b quantities
+// (m_pkg::packet_word_off_t) and therefore wrap in packets exceeding
+// 256 words.
+constexpr std::size_t WORD_OFF_N = 256;
+
+// Word 'i' of 'pkt'; bytes beyond the end of the packet are zero.
+std::uint64_t word(const Packet& pkt, std::size_t i) {
+  const std::size_t off = i * 8;
+  if ((off + 8) <= pkt.bytes) return kernel::load(pkt.data, off);
+
+  std::uint64_t w = 0;
+  std::memcpy(&w, pkt.data + off, pkt.bytes - off);
+  return w;
+}
+
+// match_type_PROC: the 4B type falls within a single word at byte 0
+// to 4 and must fall entirely within the valid bytes of the word
+// (len_to_unary_mask on the final word).
+bool match_type(const Rule& rule, const Packet& pkt) {
+  const std::size_t off = rule.type_off & 0x7;
+  if (off > 4) return false;
+
+  const std::size_t words = (pkt.bytes + 7) / 8;
+  for (std::size_t i = (rule.type_off >> 3) & 0xFF; i < words;
+       i += WORD_OFF_N) {
+    if (((i * 8) + off + 4) > pkt.bytes) break;
+
+    const std::uint32_t t = static_cast<std::uint32_t>(word(pkt, i) >> (off * 8));
+    if (t == rule.type) return true;
+  }
+  return false;
+}
+
+} // namespace
+
+const char* to_string(Isa isa) {
+  switch (isa) {
+    case Isa::Scalar: return "scalar";
+    case Isa::Avx2: return "avx2";
+    case Isa::Avx512: return "avx512";
+  }
+  return "unknown";
+}
+
+bool supported(Isa isa) {
+  switch (isa) {
+    case Isa::Scalar:
+      return true;
+    case Isa::Avx2:
+#ifdef M_SW_HAVE_AVX2
+      return __builtin_cpu_supports("avx2");
+#else
+      return false;
+#endif
+    case Isa::Avx512:
+#ifdef M_SW_HAVE_AVX512
+      return __builtin_cpu_supports("avx512f");
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+Isa best_isa() {
+  for (Isa isa : {Isa::Avx512, Isa::Avx2}) {
+    if (supported(isa)) return isa;
+  }
+  return Isa::Scalar;
+}
+
+Matcher::Matcher(Isa isa, std::size_t threads)
+    : isa_(supported(isa) ? isa : Isa::Scalar),
+      threads_(std::max<std::size_t>(threads, 1)),
+      scan_(kernel::scan_scalar) {
+  switch (isa_) {
+#ifdef M_SW_HAVE_AVX2
+    case Isa::Avx2: scan_ = kernel::scan_avx2; break;
+#endif
+#ifdef M_SW_HAVE_AVX512
+    case Isa::Avx512: scan_ = kernel::scan_avx512; break;
+#endif
+    default: break;
+  }
+}
+
+Outcome Matcher::outcome(const Rule& rule, const Packet& pkt) const {
+  Outcome o;
+  if (!match_type(rule, pkt)) return o;
+
+  o.type = true;
+
+  // match_symbol_PROC: a symbol is 8B and therefore matches only
+  // against entirely valid words. Where multiple symbols match, the
+  // final matching word in the packet takes priority and, within a
+  // word, the highest indexed symbol.
+  const std::size_t words = pkt.bytes / 8;
+
+  std::size_t match_word = 0;
+  int match_i = -1;
+  if (rule.symbol_anywhere) {
+    std::uint64_t sym[4];
+    std::size_t k = 0;
+    for (const Symbol& s : rule.symbol) {
+      if (s.valid) { sym[k++] = s.match; }
+    }
+    if (k == 0) return o;
+
+    match_word = scan_(pkt.data, words, sym, k);
+    if (match_word == words) return o;
+
+    const std::uint64_t w = word(pkt, match_word);
+    for (int i = 0; i < 4; i++) {
+      if (rule.symbol[i].valid && (rule.symbol[i].match == w)) { match_i = i; }
+    }
+  } else {
+    for (int i = 0; i < 4; i++) {
+      const Symbol& s{rule.symbol[i]};
+      if (!s.valid) continue;
+
+      for (std::size_t j = s.off; j < words; j += WORD_OFF_N) {
+        if ((word(pkt, j) == s.match) && ((match_i < 0) || (j >= match_word))) {
+          match_word = j;
+          match_i = i;
+        }
+      }
+    }
+  }
+  if (match_i >= 0) {
+    o.hit = true;
+    o.slot = static_cast<std::uint8_t>(match_i);
+    o.buffer = rule.symbol[match_i].buffer;
+  }
+  return o;
+}
+
+void Matcher::match(const std::vector<Rule>& rules, const Packet* pkts,
+                    std::size_t n, std::uint8_t* verdict) const {
+  const std::size_t threads = std::min(threads_, n);
+  if (threads <= 1) {
+    match_range(rules, pkts, 0, n, verdict);
+    return;
+  }
+
+  // Packets are distributed across threads in contiguous ranges;
+  // verdicts are written to disjoint locations.
+  std::vector<std::thread> ts;
+  ts.reserve(threads - 1);
+  const std::size_t chunk = (n + threads - 1) / threads;
+  for (std::size_t t = 1; t < threads; t++) {
+    const std::size_t begin = std::min(n, t * chunk);
+    const std::size_t end = std::min(n, begin + chunk);
+    ts.emplace_back([=, &rules]() {
+      match_range(rules, pkts, begin, end, verdict);
+    });
+  }
+  match_range(rules, pkts, 0, std::min(n, chunk), verdict);
+  for (std::thread& t : ts) { t.join(); }
+}
+
+void Matcher::match_range(const std::vector<Rule>& rules, const Packet* pkts,
+                          std::size_t begin, std::size_t end,
+                          std::uint8_t* verdict) const {
+  for (std::size_t i = begin; i < end; i++) {
+    verdict[i] = match(rules[pkts[i].rule], pkts[i]);
+  }
+}
+
+} // namespace m
@@ -0,0 +1,158 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_SW_MATCHER_H
+#define M_SW_MATCHER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace m {
+
+// Software equivalent of the match logic in m.sv (fsm_PROC,
+// match_type_PROC and match_symbol_PROC) for hosts without the
+// FPGA. Packets are presented whole, as they appear to the match
+// logic once realigned: byte 0 of the packet is byte 0 of word 0,
+// and words are little-endian 8B quantities.
+
+// Symbol match (m_pkg::sym_match_t).
+struct Symbol {
+  // Validity
+  bool valid = false;
+
+  // Word offset (in 8B words)
+  std::uint8_t off = 0;
+
+  // 8B match word
+  std::uint64_t match = 0;
+
+  // "Buffer" (Key) on a match operation.
+  std::uint8_t buffer = 0;
+};
+
+// Rule set (m_pkg::rule_t).
+struct Rule {
+  // Byte offset of the 4B packet type (m_pkg::packet_off_t; the 8B
+  // word in bits [10:3], the byte within the word in bits [2:0]).
+  std::uint16_t type_off = 0;
+
+  // Packet type
+  std::uint32_t type = 0;
+
+  // Symbols are matched against every payload word; offsets are
+  // disregarded.
+  bool symbol_anywhere = false;
+
+  // Symbol matches
+  std::array<Symbol, 4> symbol;
+};
+
+struct Packet {
+  // Packet bytes
+  const std::uint8_t* data = nullptr;
+
+  // Number of bytes in packet (non-zero)
+  std::size_t bytes = 0;
+
+  // Rule set index
+  std::size_t rule = 0;
+};
+
+// Outcome of the match of a single packet (m_pkg::status_t and the
+// verdict).
+struct Outcome {
+  // Packet type found.
+  bool type = false;
+
+  // Packet type and a symbol found; the packet matched.
+  bool hit = false;
+
+  // Index of the matching symbol (when 'hit').
+  std::uint8_t slot = 0;
+
+  // Verdict; the 'buffer' of the matching symbol (zero when the
+  // packet did not match).
+  std::uint8_t buffer = 0;
+};
+
+// Kernel instruction set.
+enum class Isa { Scalar, Avx2, Avx512 };
+
+const char* to_string(Isa isa);
+
+// Kernel is supported by both the build and the host.
+bool supported(Isa isa);
+
+// Most capable kernel supported by both the build and the host.
+Isa best_isa();
+
+class Matcher {
+ public:
+  explicit Matcher(Isa isa = best_isa(), std::size_t threads = 1);
+
+  Isa isa() const { return isa_; }
+
+  std::size_t threads() const { return threads_; }
+
+  // Compute the verdict of a single packet: the 'buffer' emitted on
+  // EOP (zero when the packet did not match).
+  std::uint8_t match(const Rule& rule, const Packet& pkt) const {
+    return outcome(rule, pkt).buffer;
+  }
+
+  // Compute the outcome of a single packet; the verdict and the
+  // status reported in its completion descriptor.
+  Outcome outcome(const Rule& rule, const Packet& pkt) const;
+
+  // Compute the verdicts of 'n' packets, distributed across the
+  // configured number of threads.
+  void match(const std::vector<Rule>& rules, const Packet* pkts,
+             std::size_t n, std::uint8_t* verdict) const;
+
+ private:
+  // Verdicts of packets [begin, end) on the calling thread.
+  void match_range(const std::vector<Rule>& rules, const Packet* pkts,
+                   std::size_t begin, std::size_t end,
+                   std::uint8_t* verdict) const;
+
+  // Kernel: index of the final word in [0, n) equal to any of the
+  // 'k' words in 'sym', or 'n' if none.
+  using scan_fn = std::size_t (*)(const std::uint8_t* data, std::size_t n,
+                                  const std::uint64_t* sym, std::size_t k);
+
+  Isa isa_;
+
+  std::size_t threads_;
+
+  scan_fn scan_;
+};
+
+} // namespace m
+
+#endif
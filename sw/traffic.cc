@@ -0,0 +1,175 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "traffic.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+
+namespace m::traffic {
+
+std::size_t UniformLength::draw(Rng& rng) {
+  return std::uniform_int_distribution<std::size_t>(lo_, hi_)(rng);
+}
+
+HistogramLength::HistogramLength(const std::vector<Bin>& bins) : bins_(bins) {
+  std::vector<double> w;
+  for (const Bin& b : bins_) { w.push_back(b.weight); }
+  select_ = std::discrete_distribution<std::size_t>(w.begin(), w.end());
+}
+
+std::size_t HistogramLength::draw(Rng& rng) {
+  const Bin& b{bins_[select_(rng)]};
+  return std::uniform_int_distribution<std::size_t>(b.lo, b.hi)(rng);
+}
+
+bool BernoulliBubble::draw(Rng& rng) {
+  return std::bernoulli_distribution(p_)(rng);
+}
+
+bool OnOffBubble::draw(Rng& rng) {
+  // Each word ends the current period with probability 1/mean.
+  const double mean = off_ ? mean_off_ : mean_on_;
+  if (std::bernoulli_distribution(1.0 / std::max(mean, 1.0))(rng)) {
+    off_ = !off_;
+  }
+  return off_;
+}
+
+ZipfFlow::ZipfFlow(std::size_t n, double s) {
+  double sum = 0.0;
+  for (std::size_t k = 1; k <= n; k++) {
+    sum += 1.0 / std::pow(static_cast<double>(k), s);
+    cdf_.push_back(sum);
+  }
+  for (double& c : cdf_) { c /= sum; }
+}
+
+std::size_t ZipfFlow::draw(Rng& rng) {
+  const double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+  const auto it = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+  return std::min<std::size_t>(it - cdf_.begin(), cdf_.size() - 1);
+}
+
+namespace {
+
+// Simple IMIX (Ethernet frame sizes, 7:4:1).
+std::vector<HistogramLength::Bin> imix() {
+  return {{64, 64, 7}, {594, 594, 4}, {1518, 1518, 1}};
+}
+
+std::map<std::string, Factory>& registry() {
+  static std::map<std::string, Factory> r{
+    {"uniform", []() {
+      // Legacy regression traffic.
+      auto p = std::make_unique<Profile>();
+      p->length = std::make_unique<UniformLength>(1, 1500);
+      p->bubble = std::make_unique<BernoulliBubble>(0.05);
+      p->flow = std::make_unique<UniqueFlow>();
+      p->hit_ratio = 0.5;
+      return p;
+    }},
+    {"imix", []() {
+      auto p = std::make_unique<Profile>();
+      p->length = std::make_unique<HistogramLength>(imix());
+      p->bubble = std::make_unique<BernoulliBubble>(0.0);
+      p->flow = std::make_unique<ZipfFlow>(1024, 1.0);
+      p->hit_ratio = 0.1;
+      return p;
+    }},
+    {"imix_bursty", []() {
+      auto p = std::make_unique<Profile>();
+      p->length = std::make_unique<HistogramLength>(imix());
+      p->bubble = std::make_unique<OnOffBubble>(256.0, 32.0);
+      p->flow = std::make_unique<ZipfFlow>(1024, 1.0);
+      p->hit_ratio = 0.1;
+      return p;
+    }},
+    {"datacenter", []() {
+      // Bimodal; predominantly small (control, ACK) and full-sized
+      // (bulk transfer) packets.
+      auto p = std::make_unique<Profile>();
+      p->length = std::make_unique<HistogramLength>(
+          std::vector<HistogramLength::Bin>{{64, 127, 0.45}, {128, 255, 0.08},
+                                            {256, 511, 0.05}, {512, 1023, 0.07},
+                                            {1024, 1499, 0.05},
+                                            {1500, 1500, 0.30}});
+      p->bubble = std::make_unique<OnOffBubble>(1024.0, 64.0);
+      p->flow = std::make_unique<ZipfFlow>(4096, 1.2);
+      p->hit_ratio = 0.02;
+      return p;
+    }},
+  };
+  return r;
+}
+
+} // namespace
+
+void register_profile(const std::string& name, Factory f) {
+  registry()[name] = std::move(f);
+}
+
+std::unique_ptr<Profile> make_profile(const std::string& name) {
+  std::size_t pos = name.find(':');
+  const auto it = registry().find(name.substr(0, pos));
+  if (it == registry().end()) return nullptr;
+
+  std::unique_ptr<Profile> p = it->second();
+  p->name = name;
+
+  // Overrides; ':key=value' each.
+  while (pos != std::string::npos) {
+    const std::size_t next = name.find(':', pos + 1);
+    const std::string kv = name.substr(pos + 1, next - pos - 1);
+    const std::size_t eq = kv.find('=');
+    if (eq == std::string::npos) return nullptr;
+
+    const std::string key = kv.substr(0, eq);
+    const std::string value = kv.substr(eq + 1);
+    if (key == "hit") {
+      char* end = nullptr;
+      const double v = std::strtod(value.c_str(), &end);
+      if (value.empty() || (*end != '\0') || !(v >= 0.0) || (v > 1.0)) {
+        return nullptr;
+      }
+      p->hit_ratio = v;
+    } else {
+      return nullptr;
+    }
+    pos = next;
+  }
+  return p;
+}
+
+std::vector<std::string> profile_names() {
+  std::vector<std::string> names;
+  for (const auto& [name, f] : registry()) { names.push_back(name); }
+  return names;
+}
+
+} // namespace m::traffic
@@ -0,0 +1,176 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_SW_TRAFFIC_H
+#define M_SW_TRAFFIC_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace m::traffic {
+
+// Traffic profiles; models of packet length, channel occupancy and
+// flow mix, selectable by name from the regression and benchmarks.
+
+using Rng = std::mt19937;
+
+// Packet length (in bytes) model.
+class LengthModel {
+ public:
+  virtual ~LengthModel() = default;
+
+  virtual std::size_t draw(Rng& rng) = 0;
+};
+
+// Lengths uniformly distributed in [lo, hi].
+class UniformLength : public LengthModel {
+ public:
+  UniformLength(std::size_t lo, std::size_t hi) : lo_(lo), hi_(hi) {}
+
+  std::size_t draw(Rng& rng) override;
+
+ private:
+  std::size_t lo_, hi_;
+};
+
+// Empirical length histogram; a bin is selected by weight, and a
+// length drawn uniformly within the bin (lo == hi for a point mass,
+// as in IMIX).
+class HistogramLength : public LengthModel {
+ public:
+  struct Bin {
+    std::size_t lo, hi;
+    double weight;
+  };
+
+  explicit HistogramLength(const std::vector<Bin>& bins);
+
+  std::size_t draw(Rng& rng) override;
+
+ private:
+  std::vector<Bin> bins_;
+  std::discrete_distribution<std::size_t> select_;
+};
+
+// Channel occupancy model; invoked once per word, returns true where
+// the word is a bubble.
+class BubbleModel {
+ public:
+  virtual ~BubbleModel() = default;
+
+  virtual bool draw(Rng& rng) = 0;
+};
+
+// Independent bubbles with probability 'p'.
+class BernoulliBubble : public BubbleModel {
+ public:
+  explicit BernoulliBubble(double p) : p_(p) {}
+
+  bool draw(Rng& rng) override;
+
+ private:
+  double p_;
+};
+
+// On/off (burst) model; the channel alternates between bursts of
+// back-to-back words and idle periods, each of geometrically
+// distributed duration with the given means (in words).
+class OnOffBubble : public BubbleModel {
+ public:
+  OnOffBubble(double mean_on, double mean_off)
+      : mean_on_(mean_on), mean_off_(mean_off) {}
+
+  bool draw(Rng& rng) override;
+
+ private:
+  double mean_on_, mean_off_;
+  bool off_ = false;
+};
+
+// Flow model; packets of the same flow share a rule set.
+class FlowModel {
+ public:
+  virtual ~FlowModel() = default;
+
+  virtual std::size_t draw(Rng& rng) = 0;
+};
+
+// Every packet is a new flow.
+class UniqueFlow : public FlowModel {
+ public:
+  std::size_t draw(Rng&) override { return next_++; }
+
+ private:
+  std::size_t next_ = 0;
+};
+
+// Flows [0, n) with Zipf-distributed popularity of exponent 's'.
+class ZipfFlow : public FlowModel {
+ public:
+  ZipfFlow(std::size_t n, double s);
+
+  std::size_t draw(Rng& rng) override;
+
+ private:
+  // Cumulative distribution over flow rank.
+  std::vector<double> cdf_;
+};
+
+struct Profile {
+  std::string name;
+
+  std::unique_ptr<LengthModel> length;
+
+  std::unique_ptr<BubbleModel> bubble;
+
+  std::unique_ptr<FlowModel> flow;
+
+  // Fraction of packets which match their rule set.
+  double hit_ratio = 0.5;
+};
+
+using Factory = std::function<std::unique_ptr<Profile>()>;
+
+// Register profile 'name'; replaces any existing profile of the same
+// name.
+void register_profile(const std::string& name, Factory f);
+
+// Construct profile 'name'; nullptr if unknown. The name may carry
+// overrides of the registered profile, each as a ':key=value' suffix;
+// 'hit' sets the hit-ratio (in [0, 1]), e.g. "imix:hit=0.9".
+std::unique_ptr<Profile> make_profile(const std::string& name);
+
+// Names of all registered profiles.
+std::vector<std::string> profile_names();
+
+} // namespace m::traffic
+
+#endif
@@ -0,0 +1,80 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_BLOOM_H
+#define M_TB_BLOOM_H
+
+#include <cstdint>
+
+namespace tb {
+
+// Reference model of the RTL symbol Bloom filter (m_pkg::bloom_h0,
+// m_pkg::bloom_h1); a 64b filter indexed by two XOR-fold hashes of
+// the 8B word.
+//
+class BloomFilter {
+ public:
+  static constexpr std::size_t W = 64;
+
+  static std::size_t h0(std::uint64_t w) {
+    std::size_t h = 0;
+    for (std::size_t i = 0; i < 64; i++) {
+      h ^= ((w >> i) & 1) << (i % 6);
+    }
+    return h;
+  }
+
+  static std::size_t h1(std::uint64_t w) {
+    std::size_t h = 0;
+    for (std::size_t i = 0; i < 64; i++) {
+      h ^= ((w >> i) & 1) << ((i + (i / 8)) % 6);
+    }
+    return h;
+  }
+
+  BloomFilter() = default;
+
+  // Add word to the filter.
+  void add(std::uint64_t w) {
+    bits_ |= (1ull << h0(w));
+    bits_ |= (1ull << h1(w));
+  }
+
+  // Word possibly present in the filter.
+  bool hit(std::uint64_t w) const {
+    return ((bits_ >> h0(w)) & 1) && ((bits_ >> h1(w)) & 1);
+  }
+
+  std::uint64_t bits() const { return bits_; }
+
+ private:
+  std::uint64_t bits_ = 0;
+};
+
+} // namespace tb
+
+#endif
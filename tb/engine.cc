@@ -0,0 +1,349 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "engine.h"
+#include "ports.h"
+#include <algorithm>
+
+namespace tb {
+
+Engine::Engine(const Options& opts, Callback cb)
+    : opts_(opts), cb_(std::move(cb)),
+      submit_q_(opts.submit_n), complete_q_(opts.complete_n),
+      instances_(K) {
+  thread_ = std::thread([this] { simulate(); });
+}
+
+Engine::~Engine() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+bool Engine::submit(std::uint64_t tag, const m::Rule& rule,
+                    const m::Packet& pkt) {
+  // Packets are of 1B to 2KB.
+  if ((pkt.bytes == 0) || (pkt.bytes > 2048)) return false;
+
+  Job job;
+  job.tag = tag;
+  job.rule = rule;
+  job.data.assign(pkt.data, pkt.data + pkt.bytes);
+  if (!submit_q_.push(job)) return false;
+
+  submitted_++;
+  if (sleeping_) {
+    // Simulation thread is suspended (or about to be); the mutex
+    // orders the notification after the thread has begun to wait.
+    std::lock_guard<std::mutex> lk(mtx_);
+    cv_.notify_one();
+  }
+  return true;
+}
+
+bool Engine::poll(Completion& c) {
+  return complete_q_.pop(c);
+}
+
+void Engine::flush() {
+  const std::size_t target = submitted_;
+
+  flushing_++;
+  std::unique_lock<std::mutex> lk(mtx_);
+  flush_cv_.wait(lk, [&] { return completed_ >= target; });
+  flushing_--;
+}
+
+Engine::Stats Engine::stats() const {
+  Stats s;
+  s.submitted = submitted_;
+  s.completed = completed_;
+  s.time = completed_time_;
+  s.unexpected = unexpected_;
+  s.dropped = dropped_;
+  return s;
+}
+
+void Engine::simulate() {
+  // The model is constructed, evaluated and destroyed on the
+  // simulation thread alone.
+  tb_ = new Vtb("tb");
+  tb_->clk_net = false;
+  tb_->rst_net = false;
+  tb_->clk_host = false;
+  tb_->rst_host = false;
+
+  net_state_ = State::PreReset;
+  net_reset_ticks_ = 10;
+  host_state_ = State::PreReset;
+  host_reset_ticks_ = 10;
+
+  for (std::size_t k = 0; k < K; k++) {
+    InDriver::drive(tb_, k);
+    RuleDriver::drive(tb_, k);
+
+    // Every packet completes on its EOP at the egress; words are
+    // forwarded unfiltered.
+    EgressDriver::drive(tb_, k, EgressConfig{});
+    CplDriver::drive(tb_, k, CplConfig{});
+    CplDriver::consume(tb_, k, 0);
+  }
+
+  for (;;) {
+    accept();
+    if (!idle()) {
+      step();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    if (stop_) break;
+
+    // Suspend until further packets are submitted; a submission which
+    // precedes 'sleeping_' is observed by the predicate, and one
+    // which follows it notifies.
+    sleeping_ = true;
+    cv_.wait(lk, [&] { return stop_ || (submitted_ != accepted_); });
+    sleeping_ = false;
+  }
+
+  delete tb_;
+  tb_ = nullptr;
+}
+
+void Engine::accept() {
+  // Packets are retained in the submission queue (and subsequent
+  // submissions refused) once each instance has a window of pending
+  // packets; sufficient to keep the rule table full.
+  const std::size_t window = 2 * RULE_N;
+
+  for (;;) {
+    auto it = std::min_element(
+        instances_.begin(), instances_.end(),
+        [](const Instance& a, const Instance& b) {
+          return (a.pending.size() + a.inflight.size()) <
+                 (b.pending.size() + b.inflight.size());
+        });
+    if (it->pending.size() >= window) break;
+
+    Job job;
+    if (!submit_q_.pop(job)) break;
+
+    it->pending.push_back(std::move(job));
+    accepted_++;
+  }
+}
+
+bool Engine::idle() const {
+  if ((net_state_ != State::Active) || (host_state_ != State::Active)) {
+    // Reset remains in progress.
+    return false;
+  }
+  for (const Instance& i : instances_) {
+    if (!i.pending.empty() || !i.inflight.empty() || i.cfg.busy) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Engine::step() {
+  time_++;
+
+  if (time_ % opts_.net_half_period == 0) {
+    if (tb_->clk_net) {
+      on_net_clk_negedge();
+    }
+    tb_->clk_net = !tb_->clk_net;
+  }
+  if (time_ % opts_.host_half_period == 0) {
+    if (tb_->clk_host) {
+      on_host_clk_negedge();
+    }
+    tb_->clk_host = !tb_->clk_host;
+  }
+  tb_->eval();
+}
+
+void Engine::on_net_clk_negedge() {
+  switch (net_state_) {
+    case State::PreReset: {
+      tb_->rst_net = true;
+      net_state_ = State::InReset;
+    } break;
+    case State::InReset: {
+      if (--net_reset_ticks_ == 0) {
+        tb_->rst_net = false;
+        net_state_ = State::Active;
+      }
+    } break;
+    case State::Active: {
+      for (std::size_t k = 0; k < K; k++) {
+        on_net_drive(k);
+      }
+    } break;
+  }
+}
+
+void Engine::on_net_drive(std::size_t k) {
+  Instance& i{instances_[k]};
+
+  InDriver::drive(tb_, k);
+
+  // Ingress is stalled; no beat is issued until ready.
+  if (!InDriver::ready(tb_, k)) return;
+
+  std::deque<In>& ins = i.actual_in;
+  if (ins.empty()) {
+    // Start the next packet, once its rule set is active.
+    if (i.pending.empty() || (i.cfg.committed <= i.started)) return;
+
+    Job& job = i.pending.front();
+    const std::vector<std::uint8_t>& d{job.data};
+    const std::size_t beats = (d.size() + 7) / 8;
+    for (std::size_t b = 0; b < beats; b++) {
+      In in;
+      in.valid = true;
+      in.sop = (b == 0);
+      in.eop = (b == (beats - 1));
+      in.length = in.eop ? ((d.size() - 1) % 8) : 0;
+      // Words are little-endian 8B quantities.
+      for (std::size_t j = 0; j < 8 && (b * 8 + j) < d.size(); j++) {
+        in.data |= static_cast<vluint64_t>(d[b * 8 + j]) << (j * 8);
+      }
+      in.rule = (i.started % RULE_N);
+      ins.push_back(in);
+    }
+    i.started++;
+
+    job.start = time_;
+    i.inflight.push_back(std::move(job));
+    i.pending.pop_front();
+  }
+  InDriver::drive(tb_, k, ins.front());
+  ins.pop_front();
+}
+
+void Engine::on_host_clk_negedge() {
+  switch (host_state_) {
+    case State::PreReset: {
+      tb_->rst_host = true;
+      host_state_ = State::InReset;
+    } break;
+    case State::InReset: {
+      if (--host_reset_ticks_ == 0) {
+        tb_->rst_host = false;
+        host_state_ = State::Active;
+      }
+    } break;
+    case State::Active: {
+      for (std::size_t k = 0; k < K; k++) {
+        on_host_cfg(k);
+        on_host_observe(k);
+      }
+    } break;
+  }
+}
+
+void Engine::on_host_cfg(std::size_t k) {
+  Instance& i{instances_[k]};
+
+  RuleDriver::drive(tb_, k);
+
+  if (i.cfg.busy) {
+    if (!RuleDriver::busy(tb_, k)) {
+      i.cfg.committed = i.cfg.target;
+      i.cfg.busy = false;
+    }
+    return;
+  }
+
+  // As TB::on_host_cfg; packets which have started are no longer
+  // 'pending'.
+  const std::size_t started = i.started;
+  const std::size_t next = i.cfg.written;
+  if ((next < (started + RULE_N)) && ((next - started) < i.pending.size())) {
+    RuleDriver::drive(tb_, k, next % RULE_N, i.pending[next - started].rule);
+    i.cfg.written++;
+  } else if (i.cfg.written != i.cfg.committed) {
+    RuleDriver::commit(tb_, k);
+    i.cfg.busy = true;
+    i.cfg.target = i.cfg.written;
+  }
+}
+
+void Engine::on_host_observe(std::size_t k) {
+  Instance& i{instances_[k]};
+
+  // Completions are taken from the egress directly; descriptors are
+  // returned to the completion ring as they are written.
+  CplDriver::consume(tb_, k, CplDriver::prod(tb_, k));
+
+  const Out out = OutMonitor::get(tb_, k);
+  if (!out.valid || !out.eop) return;
+
+  // An EOP with no packet in flight is not attributable to any
+  // submission; it is counted and otherwise discarded.
+  if (i.inflight.empty()) {
+    unexpected_++;
+    return;
+  }
+
+  // Packets are emitted in the order in which they were driven.
+  Job& job = i.inflight.front();
+  complete(Completion{job.tag, out.buffer, k, time_ - job.start});
+  i.inflight.pop_front();
+}
+
+void Engine::complete(const Completion& c) {
+  if (cb_) {
+    cb_(c);
+  } else {
+    Completion v{c};
+    while (!complete_q_.push(v)) {
+      // Completion queue is full; await the consumer, unless the
+      // engine is being destroyed, whereupon no consumer remains.
+      if (stop_) {
+        dropped_++;
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+  completed_time_ = time_;
+  completed_++;
+
+  if (flushing_ != 0) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    flush_cv_.notify_all();
+  }
+}
+
+} // namespace tb
@@ -0,0 +1,256 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_ENGINE_H
+#define M_TB_ENGINE_H
+
+#include "tb.h"
+#include "queue.h"
+#include "matcher.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tb {
+
+// Streaming front-end to the Verilated model, for use as a
+// cycle-accurate backend by software other than the regression.
+//
+// Packets are submitted, from any thread, together with the rule set
+// against which they are matched. A dedicated thread runs the
+// simulation: submitted packets are distributed across the K
+// instances of the model, rule sets are programmed ahead of the
+// packets which use them, and packets are driven back-to-back at the
+// ingress. The verdict of each packet is returned upon emission of
+// its EOP word at the egress, either to a callback or by way of a
+// completion queue.
+//
+// Simulation is suspended whilst there is no outstanding work; time
+// therefore only advances whilst packets are in flight.
+//
+class Engine {
+ public:
+  struct Options {
+    // Clock half-periods (in simulation time units); as tb::Options.
+    vluint64_t net_half_period = 10;
+    vluint64_t host_half_period = 5;
+
+    // Capacity (in packets) of the submission and completion queues.
+    std::size_t submit_n = 1024;
+    std::size_t complete_n = 1024;
+  };
+
+  struct Completion {
+    // Tag of the packet (as submitted).
+    std::uint64_t tag = 0;
+
+    // Verdict: the 'buffer' emitted on EOP (zero where the packet did
+    // not match, as m::Matcher::match).
+    vluint8_t verdict = 0;
+
+    // Instance of the model which processed the packet.
+    std::size_t instance = 0;
+
+    // Latency (in simulation time units) from the SOP word being
+    // driven at the ingress, to the EOP word being observed at the
+    // egress.
+    vluint64_t latency = 0;
+  };
+
+  using Callback = std::function<void(const Completion&)>;
+
+  struct Stats {
+    // Packets submitted and completed.
+    std::size_t submitted = 0;
+    std::size_t completed = 0;
+
+    // Simulation time at the most recent completion.
+    vluint64_t time = 0;
+
+    // EOP words observed at the egress with no packet in flight on
+    // the instance; non-zero indicates an error in the model.
+    std::size_t unexpected = 0;
+
+    // Completions discarded on destruction of the engine whilst the
+    // completion queue was full.
+    std::size_t dropped = 0;
+  };
+
+  // Completions are delivered to 'cb' on the simulation thread, where
+  // provided; otherwise, they are retrieved by poll().
+  explicit Engine(const Options& opts, Callback cb = nullptr);
+  Engine() : Engine(Options()) {}
+
+  // Outstanding packets are completed before the simulation thread
+  // exits. In the absence of a callback, completions which do not fit
+  // the completion queue are discarded (see: Stats::dropped) rather
+  // than awaiting poll().
+  ~Engine();
+
+  Engine(const Engine&) = delete;
+  Engine& operator=(const Engine&) = delete;
+
+  // Submit packet 'pkt' (of at most 2KB) to be matched against rule
+  // set 'rule'; the packet bytes are copied, and 'pkt.rule' is
+  // disregarded. Returns false where the packet is empty or exceeds
+  // 2KB, or where the submission queue is full. Thread-safe.
+  bool submit(std::uint64_t tag, const m::Rule& rule, const m::Packet& pkt);
+
+  // Retrieve the next completion; false where none is available.
+  // Thread-safe.
+  bool poll(Completion& c);
+
+  // Block until all packets submitted prior to the call have
+  // completed. In the absence of a callback, completions must be
+  // retrieved concurrently where more than 'complete_n' packets are
+  // outstanding.
+  void flush();
+
+  Stats stats() const;
+
+ private:
+  enum class State {
+    PreReset,
+    InReset,
+    Active
+  };
+
+  struct Job {
+    // Packet tag
+    std::uint64_t tag = 0;
+
+    // Rule set
+    m::Rule rule;
+
+    // Packet bytes
+    std::vector<std::uint8_t> data;
+
+    // Time at which the SOP word was driven.
+    vluint64_t start = 0;
+  };
+
+  // Per-instance state (simulation thread only).
+  struct Instance {
+    // Packets yet to be started.
+    std::deque<Job> pending;
+
+    // Packets started, awaiting emission (in order).
+    std::deque<Job> inflight;
+
+    // Stimulus of the current packet.
+    std::deque<In> actual_in;
+
+    // Number of packets started.
+    std::size_t started = 0;
+
+    // Rule table configuration state (see: TB::Instance).
+    struct {
+      std::size_t written = 0;
+      std::size_t committed = 0;
+      bool busy = false;
+      std::size_t target = 0;
+    } cfg;
+  };
+
+  // Simulation thread
+  void simulate();
+
+  // Transfer submitted packets to instances.
+  void accept();
+
+  // No work is outstanding.
+  bool idle() const;
+
+  // Advance simulation by one time unit.
+  void step();
+
+  void on_net_clk_negedge();
+
+  void on_host_clk_negedge();
+
+  void on_net_drive(std::size_t k);
+
+  void on_host_cfg(std::size_t k);
+
+  void on_host_observe(std::size_t k);
+
+  // Return completion 'c' to the caller.
+  void complete(const Completion& c);
+
+
+  Options opts_;
+
+  Callback cb_;
+
+  MpmcQueue<Job> submit_q_;
+
+  MpmcQueue<Completion> complete_q_;
+
+  // Packets submitted, accepted by the simulation thread, and
+  // completed.
+  std::atomic<std::size_t> submitted_{0};
+  std::size_t accepted_ = 0;
+  std::atomic<std::size_t> completed_{0};
+
+  // Simulation time at the most recent completion.
+  std::atomic<vluint64_t> completed_time_{0};
+
+  // EOP words observed with no packet in flight.
+  std::atomic<std::size_t> unexpected_{0};
+
+  // Completions discarded on destruction.
+  std::atomic<std::size_t> dropped_{0};
+
+  // Suspension of the simulation thread whilst idle, and of callers
+  // of flush().
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::condition_variable flush_cv_;
+  std::atomic<bool> sleeping_{false};
+  std::atomic<std::size_t> flushing_{0};
+  std::atomic<bool> stop_{false};
+
+  // Simulation state (simulation thread only).
+  Vtb* tb_ = nullptr;
+  vluint64_t time_ = 0;
+  State net_state_ = State::PreReset;
+  State host_state_ = State::PreReset;
+  vluint8_t net_reset_ticks_ = 0;
+  vluint8_t host_reset_ticks_ = 0;
+  std::vector<Instance> instances_;
+
+  std::thread thread_;
+};
+
+} // namespace tb
+
+#endif
@@ -0,0 +1,222 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+// In-process, coverage-guided differential fuzz harness (libFuzzer).
+// Each input is decoded into rule sets and an arbitrary stream of
+// ingress beats, which is simulated on the Verilated RTL and checked
+// against the reference model (see: model.h, scoreboard.h); any
+// discrepancy is a test failure, which aborts the input as a crash.
+//
+// Unlike the regression (see: tests/regress.cc), framing is
+// unconstrained: SOP without EOP, successive SOP, EOP outside of a
+// packet, and arbitrary offsets and lengths on any word, such that
+// the resynchronization paths of the RTL are exercised.
+//
+// The Verilated model is instrumented for coverage (OPT_FUZZ_ENABLE),
+// such that each coverage point of the RTL is a distinct edge of the
+// instrumented model and therefore guides the fuzzer. Coverage
+// accumulated over the session is written on exit.
+//
+//   fuzz [corpus] [libFuzzer options]
+//   verilator_coverage --annotate <dir> fuzz_coverage.dat
+//
+
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "verilated_cov.h"
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+
+namespace {
+
+// Bound on the beats of a single input.
+constexpr std::size_t BEATS_MAX = 4096;
+
+// Bound on the words of a packet; a SOP is forced thereafter, such that
+// a packet fits within the egress buffer irrespective of the packets
+// yet to drain (see: tb::EgressModel).
+constexpr std::size_t PACKET_WORDS_MAX = 128;
+
+// Input bytes; exhausted input decodes as zeros.
+class Bytes {
+ public:
+  Bytes(const std::uint8_t* data, std::size_t size)
+      : data_(data), size_(size) {}
+
+  bool empty() const { return size_ == 0; }
+
+  template<typename T>
+  T get() {
+    T t = 0;
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+      t = static_cast<T>(t << 8) | ((size_ != 0) ? (size_--, *data_++) : 0);
+    }
+    return t;
+  }
+
+ private:
+  const std::uint8_t* data_;
+  std::size_t size_;
+};
+
+// Testbench configurations, selected by the input. Each testbench is
+// retained for the session, as the coverage of its model is retained
+// until exit.
+//
+// Packets are filtered only with the HOST clock at twice the NET
+// clock, as the egress stage stalls the clock-crossing on each packed
+// word. Completions are coalesced alongside filtering.
+tb::Options configuration(std::size_t i) {
+  tb::Options opts;
+  switch (i) {
+    case 0: break;
+    case 1: opts.host_half_period = opts.net_half_period; break;
+    case 2: {
+      opts.egress.mode = tb::EgressMode::Filter;
+      opts.cpl.count = 8;
+      opts.cpl.timeout = 32;
+    } break;
+    default: {
+      opts.egress.mode = tb::EgressMode::Truncate;
+      opts.egress.hdr = 2;
+      opts.cpl.count = 4;
+      opts.cpl_service_latency = 4;
+    } break;
+  }
+  return opts;
+}
+
+constexpr std::size_t CONFIGURATION_N = 4;
+
+tb::TB& testbench(std::size_t i) {
+  static std::array<std::unique_ptr<tb::TB>, CONFIGURATION_N> tbs;
+  if (!tbs[i]) { tbs[i] = std::make_unique<tb::TB>(configuration(i)); }
+  return *tbs[i];
+}
+
+// Rule set of a test; offsets are confined to the initial words of a
+// packet, such that they are reachable.
+void decode_rule(Bytes& b, tb::TestCase& tc) {
+  tc.type.off = b.get<std::uint8_t>() % 40;
+  tc.type.type = b.get<std::uint32_t>();
+  const std::uint8_t flags = b.get<std::uint8_t>();
+  tc.symbol_anywhere = (flags & 0x10) != 0;
+  for (std::size_t i = 0; i < 4; i++) {
+    tb::SymbolMatch m;
+    m.valid = (flags >> i) & 1;
+    m.off = b.get<std::uint8_t>() % 8;
+    m.match = b.get<std::uint64_t>();
+    m.buffer = b.get<std::uint8_t>();
+    tc.match.push_back(m);
+  }
+}
+
+// Word data; either drawn from the input, or an operand of the rule
+// set of the test, such that matches are readily formed.
+vluint64_t decode_data(Bytes& b, const tb::TestCase& tc) {
+  const std::uint8_t sel = b.get<std::uint8_t>();
+  switch (sel % 8) {
+    case 0: case 1: case 2: case 3:
+      return tc.match[sel % 4].match;
+    case 4:
+      return (static_cast<vluint64_t>(tc.type.type) <<
+              (8 * (b.get<std::uint8_t>() % 5)));
+    default:
+      return b.get<std::uint64_t>();
+  }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+  // Failures abort the input, such that it is retained as a crash.
+  GTEST_FLAG_SET(throw_on_failure, true);
+
+  std::atexit([]() { VerilatedCov::write("fuzz_coverage.dat"); });
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size) {
+  Bytes b(data, size);
+
+  tb::TB& tb{testbench(b.get<std::uint8_t>() % CONFIGURATION_N)};
+
+  // Words of the packet in progress on each channel.
+  std::array<std::size_t, tb::CHAN_N> words{};
+
+  std::deque<tb::TestCase> tests;
+  std::size_t beats = 0;
+  while (!b.empty() && (beats < BEATS_MAX)) {
+    tb::TestCase& tc = tests.emplace_back();
+    tc.id = tests.size() - 1;
+    tc.bytes = 0;
+    decode_rule(b, tc);
+
+    const std::size_t n = 1 + (b.get<std::uint8_t>() % 32);
+    for (std::size_t i = 0; i < n; i++) {
+      // Framing is biased towards packets of several words, which
+      // start at byte 0; otherwise, unconstrained.
+      const std::uint32_t flags = b.get<std::uint32_t>();
+
+      tb::In in;
+      in.valid = (flags & 0x3) != 0;
+      in.sop = ((flags >> 2) & 0x7) == 0;
+      in.eop = ((flags >> 5) & 0x7) == 0;
+      in.chan = (flags >> 8) % tb::CHAN_N;
+      in.sop_off = ((flags >> 10) & 0x1) ? ((flags >> 11) & 0x7) : 0;
+      in.length = (flags >> 14) & 0x7;
+      in.data = decode_data(b, tc);
+      if (in.valid) {
+        if (words[in.chan] >= PACKET_WORDS_MAX) { in.sop = true; }
+        words[in.chan] = in.sop ? 1 : (words[in.chan] + 1);
+      }
+      tc.bytes += in.valid ? 8 : 0;
+      tc.in.push_back(in);
+      beats++;
+    }
+  }
+  if (tests.empty()) return 0;
+
+  // Conclude the packet in progress on each channel with a single-word
+  // packet, such that all egress is expected to drain.
+  for (std::size_t chan = 0; chan < tb::CHAN_N; chan++) {
+    tb::In in;
+    in.valid = true;
+    in.chan = chan;
+    in.sop = true;
+    in.eop = true;
+    in.length = 7;
+    tests.back().in.push_back(in);
+  }
+
+  tb.run(tests);
+  return 0;
+}
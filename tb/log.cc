@@ -0,0 +1,113 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "log.h"
+#include <algorithm>
+
+namespace tb::log {
+
+EventLog& EventLog::local() {
+  static thread_local EventLog log;
+  return log;
+}
+
+EventLog::EventLog() : ring_(new Record[DEPTH]) {}
+
+EventLog::~EventLog() { detach(); }
+
+void EventLog::context(const Record& r) {
+  Context& c{context_.at(static_cast<std::size_t>(r.event))};
+  c.valid = true;
+  c.pos = head_;
+  c.r = r;
+  push() = r;
+}
+
+bool EventLog::attach(const char* fn) {
+  detach();
+  sink_ = std::fopen(fn, "wb");
+  if (sink_ == nullptr) return false;
+
+  const Header h;
+  std::fwrite(&h, sizeof(h), 1, sink_);
+  // Records prior to attach are not emitted.
+  tail_ = head_;
+  return true;
+}
+
+void EventLog::detach() {
+  if (sink_ == nullptr) return;
+
+  spill();
+  std::fclose(sink_);
+  sink_ = nullptr;
+}
+
+bool EventLog::dump(const char* fn) const {
+  std::FILE* f = std::fopen(fn, "wb");
+  if (f == nullptr) return false;
+
+  const Header h;
+  std::fwrite(&h, sizeof(h), 1, f);
+  // Retained records lie in [head_ - n, head_) and may wrap the end
+  // of the ring.
+  const std::uint64_t n = (head_ < DEPTH) ? head_ : DEPTH;
+  // Context overwritten in the ring precedes the retained records.
+  std::array<const Context*, std::tuple_size_v<decltype(context_)>> lost;
+  std::size_t lost_n = 0;
+  for (const Context& c : context_) {
+    if (c.valid && (c.pos < (head_ - n))) lost[lost_n++] = &c;
+  }
+  std::sort(lost.begin(), lost.begin() + lost_n,
+            [](const Context* a, const Context* b) { return a->pos < b->pos; });
+  for (std::size_t i = 0; i < lost_n; i++) {
+    std::fwrite(&lost[i]->r, sizeof(Record), 1, f);
+  }
+  for (std::uint64_t i = head_ - n; i != head_; i++) {
+    std::fwrite(&ring_[i & (DEPTH - 1)], sizeof(Record), 1, f);
+  }
+  std::fclose(f);
+  return true;
+}
+
+void EventLog::spill() {
+  if (sink_ != nullptr) {
+    // Emit outstanding records in (at most) two contiguous chunks.
+    while (tail_ != head_) {
+      const std::size_t i = (tail_ & (DEPTH - 1));
+      const std::size_t n =
+          std::min<std::uint64_t>(head_ - tail_, DEPTH - i);
+      std::fwrite(&ring_[i], sizeof(Record), n, sink_);
+      tail_ += n;
+    }
+  } else {
+    // No sink; oldest record is simply overwritten.
+    tail_ = head_ - (DEPTH - 1);
+  }
+}
+
+} // namespace tb::log
@@ -0,0 +1,185 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_LOG_H
+#define M_TB_LOG_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+namespace tb::log {
+
+// Logged event kinds.
+enum class Event : std::uint8_t {
+  // Random seed of the run; 'b' := seed
+  Seed,
+
+  // Testbench phase change; 'sub' := Phase
+  Phase,
+
+  // Regression environment constructed; 'a' := n, 'len' := symbol_n,
+  // 'b' := max_len, 'c' := {fail_match_probability, bubble_probability}
+  // as a pair of floats.
+  Environment,
+
+  // Testcase generated or started; 'b' := id, 'c' := bytes. On
+  // start, 'a' := instance.
+  TestGenerated,
+  TestStart,
+
+  // Beat driven on the ingress; 'a' := instance, 'flags' := {status,
+  // 0, eop, sop, valid} (status in the upper nibble), 'sub' :=
+  // {sop_off, chan} (a nibble each), 'len' := length, 'b' := data.
+  BeatDriven,
+
+  // Beat observed on the egress; as BeatDriven, 'c' := buffer.
+  BeatObserved,
+
+  // Scoreboard mismatch; 'b' := packet id, 'c' := observed digest,
+  // 'a' := beats observed.
+  Mismatch
+};
+
+// Testbench phases.
+enum class Phase : std::uint8_t {
+  Build,
+  Start,
+  Complete
+};
+
+// Fixed-size log record.
+struct Record {
+  // Simulation time (zero when recorded outside of the simulation).
+  std::uint64_t time;
+
+  // Event kind.
+  Event event;
+
+  // Event specific fields (see Event).
+  std::uint8_t flags;
+  std::uint8_t len;
+  std::uint8_t sub;
+  std::uint32_t a;
+  std::uint64_t b;
+  std::uint64_t c;
+};
+static_assert(sizeof(Record) == 32);
+
+// Binary log file header.
+struct Header {
+  char magic[4] = {'M', 'L', 'O', 'G'};
+  std::uint32_t version = 2;
+  std::uint32_t record_size = sizeof(Record);
+  std::uint32_t reserved = 0;
+};
+
+// Per-thread ring of log records. Records are written in-place into
+// a ring allocated once per thread such that logging does not
+// allocate. When no sink is attached, the ring retains the most
+// recent records (a flight recorder) which can be dumped on
+// demand. Otherwise, the ring is spilled to the sink whenever it
+// becomes full.
+//
+class EventLog {
+ public:
+  // Ring depth (in records); must be a power-of-two.
+  static constexpr std::size_t DEPTH = (1 << 16);
+
+  // Log for the calling thread.
+  static EventLog& local();
+
+  ~EventLog();
+
+  // Allocate the next record in the ring.
+  Record& push() {
+    if ((head_ - tail_) == DEPTH) spill();
+    return ring_[head_++ & (DEPTH - 1)];
+  }
+
+  // Allocate the next record in the ring and retain a copy of 'r' as
+  // context; where the record has since been overwritten in the ring,
+  // dump() reproduces the most recent context record of each kind
+  // ahead of the retained records.
+  void context(const Record& r);
+
+  // Stream all subsequent records to file 'fn'.
+  bool attach(const char* fn);
+
+  // Flush outstanding records and close sink (if attached).
+  void detach();
+
+  // Write retained records to file 'fn'.
+  bool dump(const char* fn) const;
+
+ private:
+  EventLog();
+
+  // Retire records from the ring to make space.
+  void spill();
+
+  // Ring state.
+  std::unique_ptr<Record[]> ring_;
+  std::uint64_t head_ = 0;
+  std::uint64_t tail_ = 0;
+
+  // Attached sink (if any).
+  std::FILE* sink_ = nullptr;
+
+  // Most recent context record of each kind, and its position in
+  // the ring.
+  struct Context {
+    bool valid = false;
+    std::uint64_t pos = 0;
+    Record r;
+  };
+  std::array<Context, static_cast<std::size_t>(Event::Environment) + 1>
+      context_;
+};
+
+// Convenience helpers to log common events.
+//
+inline void phase(std::uint64_t time, Phase p) {
+  Record& r = EventLog::local().push();
+  r = Record{time, Event::Phase, 0, 0, static_cast<std::uint8_t>(p), 0, 0, 0};
+}
+
+inline void beat(Event e, std::uint64_t time, std::uint32_t instance,
+                 bool valid, std::uint8_t chan, bool sop, bool eop,
+                 std::uint8_t sop_off, std::uint8_t length, std::uint64_t data,
+                 std::uint8_t status = 0, std::uint8_t buffer = 0) {
+  const std::uint8_t flags = (valid ? 1 : 0) | (sop ? 2 : 0) | (eop ? 4 : 0) |
+                             ((status & 0xF) << 4);
+  const std::uint8_t sub = (chan & 0xF) | ((sop_off & 0xF) << 4);
+  Record& r = EventLog::local().push();
+  r = Record{time, e, flags, length, sub, instance, data, buffer};
+}
+
+} // namespace tb::log
+
+#endif
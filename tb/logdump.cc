@@ -0,0 +1,176 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+// Offline decoder for binary event logs; renders records in the
+// textual format historically emitted by the testbench.
+//
+//   logdump <driver.mlog>
+//
+
+#include "log.h"
+#include "utility.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using tb::log::Event;
+using tb::log::Phase;
+using tb::log::Record;
+
+std::string render_test(const Record& r) {
+  using std::to_string;
+
+  tb::utility::KVListRenderer kv;
+  if (r.event == Event::TestStart) {
+    kv.add_field("instance", to_string(r.a));
+  }
+  kv.add_field("id", to_string(r.b));
+  kv.add_field("bytes", to_string(r.c));
+  return kv.to_string();
+}
+
+std::string render_beat(const Record& r) {
+  using std::to_string;
+
+  tb::utility::KVListRenderer kv;
+  kv.add_field("time", to_string(r.time));
+  kv.add_field("instance", to_string(r.a));
+  kv.add_field("valid", tb::utility::to_string(r.flags & 1));
+  kv.add_field("chan", to_string(r.sub & 0xF));
+  kv.add_field("sop", tb::utility::to_string(r.flags & 2));
+  kv.add_field("eop", tb::utility::to_string(r.flags & 4));
+  kv.add_field("sop_off", to_string(r.sub >> 4));
+  kv.add_field("length", to_string(r.len));
+  kv.add_field("data", tb::utility::Hexer{}.to_hex(r.b));
+  if (r.event == Event::BeatObserved) {
+    const unsigned status = (r.flags >> 4);
+    kv.add_field("type_hit", tb::utility::to_string(status & 8));
+    kv.add_field("hit", tb::utility::to_string(status & 4));
+    kv.add_field("slot", to_string(status & 3));
+    kv.add_field("buffer", tb::utility::Hexer{}.to_hex(r.c, 8));
+  }
+  return kv.to_string();
+}
+
+std::string render_environment(const Record& r) {
+  using std::to_string;
+
+  float fail_match_probability, bubble_probability;
+  const std::uint32_t hi = (r.c >> 32), lo = (r.c & 0xFFFFFFFF);
+  std::memcpy(&fail_match_probability, &hi, sizeof(float));
+  std::memcpy(&bubble_probability, &lo, sizeof(float));
+
+  tb::utility::KVListRenderer kv;
+  kv.add_field("n", to_string(r.a));
+  kv.add_field("max_len", to_string(r.b));
+  kv.add_field("symbol_n", to_string(r.len));
+  kv.add_field("bubble_probability", to_string(bubble_probability));
+  kv.add_field("fail_match_probability", to_string(fail_match_probability));
+  return kv.to_string();
+}
+
+void render(const Record& r) {
+  switch (r.event) {
+    case Event::Seed: {
+      std::cout << "[RND] seed set to " << r.b << "\n";
+    } break;
+    case Event::Phase: {
+      switch (static_cast<Phase>(r.sub)) {
+        case Phase::Build:
+          std::cout << "[TB] Building testbench\n";
+          break;
+        case Phase::Start:
+          std::cout << "[TB] Starting simulation\n";
+          break;
+        case Phase::Complete:
+          std::cout << "[TB] Simulation complete!\n";
+          break;
+      }
+    } break;
+    case Event::Environment: {
+      std::cout << "[Regress] Constructing test environment: "
+                << render_environment(r) << "\n";
+    } break;
+    case Event::TestGenerated: {
+      std::cout << "[Regress] Generate testcase: " << render_test(r) << "\n";
+    } break;
+    case Event::TestStart: {
+      std::cout << "[TB] Start test: " << render_test(r) << "\n";
+    } break;
+    case Event::BeatDriven: {
+      std::cout << "[TB] Drive: " << render_beat(r) << "\n";
+    } break;
+    case Event::BeatObserved: {
+      std::cout << "[TB] Observe: " << render_beat(r) << "\n";
+    } break;
+    case Event::Mismatch: {
+      std::cout << "[SB] Mismatch on packet " << r.b << " after " << r.a
+                << " beats (digest: " << tb::utility::Hexer{}.to_hex(r.c)
+                << ")\n";
+    } break;
+    default: {
+      std::cout << "[LOG] Unknown event: "
+                << static_cast<unsigned>(r.event) << "\n";
+    } break;
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <log>\n";
+    return 1;
+  }
+
+  std::FILE* f = std::fopen(argv[1], "rb");
+  if (f == nullptr) {
+    std::cerr << "Cannot open: " << argv[1] << "\n";
+    return 1;
+  }
+
+  tb::log::Header h;
+  const tb::log::Header expected;
+  if ((std::fread(&h, sizeof(h), 1, f) != 1) ||
+      (std::memcmp(h.magic, expected.magic, sizeof(h.magic)) != 0) ||
+      (h.version != expected.version) ||
+      (h.record_size != expected.record_size)) {
+    std::cerr << "Invalid log: " << argv[1] << "\n";
+    std::fclose(f);
+    return 1;
+  }
+
+  Record r;
+  while (std::fread(&r, sizeof(r), 1, f) == 1) {
+    render(r);
+  }
+  std::fclose(f);
+  return 0;
+}
@@ -0,0 +1,58 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+// Regression driver entry point (the fuzz harness provides its own;
+// see: fuzz.cc).
+
+#include "tb.h"
+#ifdef OPT_LOGGING_ENABLE
+#  include "log.h"
+#endif
+#ifdef OPT_PROF_ENABLE
+#  include "prof.h"
+#endif
+#include "gtest/gtest.h"
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+#ifdef OPT_PROF_ENABLE
+  // Forward the remaining arguments to Verilator; the execution
+  // profile is controlled by +verilator+prof+exec+* plusargs.
+  Verilated::commandArgs(argc, argv);
+#endif
+  const int ret = RUN_ALL_TESTS();
+#ifdef OPT_LOGGING_ENABLE
+  // Retain the most recent events for offline decode (see: logdump),
+  // preceded by the seed and environment from which they derive.
+  tb::log::EventLog::local().dump("driver.mlog");
+#endif
+#ifdef OPT_PROF_ENABLE
+  // Per-run phase profile (see: profreport).
+  tb::prof::Profile::local().dump("driver.prof");
+#endif
+  return ret;
+}
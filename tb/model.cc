@@ -0,0 +1,236 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "model.h"
+#include <algorithm>
+
+namespace tb {
+
+m::Rule to_rule(const TestCase& tc) {
+  m::Rule r;
+  r.type_off = tc.type.off;
+  r.type = tc.type.type;
+  r.symbol_anywhere = tc.symbol_anywhere;
+  for (std::size_t i = 0; i < std::min(tc.match.size(), r.symbol.size()); i++) {
+    const SymbolMatch& s{tc.match[i]};
+    r.symbol[i] = m::Symbol{s.valid, s.off, s.match, s.buffer};
+  }
+  return r;
+}
+
+// Packets are matched individually; the scalar kernel suffices.
+Model::Model() : matcher_(m::Isa::Scalar) {}
+
+void Model::write(std::size_t idx, const m::Rule& rule) {
+  written_[idx] = rule;
+  dirty_.set(idx);
+}
+
+void Model::commit() {
+  for (std::size_t i = 0; i < RULE_N; i++) {
+    if (dirty_.test(i)) { active_[i] = written_[i]; }
+  }
+  dirty_.reset();
+}
+
+bool Model::predict(const In& in, Out& out) {
+  if (!in.valid) return false;
+
+  // Packets of distinct channels are independent.
+  Context& c{ctx_[in.chan]};
+
+  // Word ends the packet in progress and starts the next.
+  const bool packed = in.sop && in.eop && (in.sop_off > in.length);
+
+  // Word continues the packet in progress; a SOP, other than in a
+  // packed word, abandons the packet in progress.
+  const bool cur = c.in_packet && (!in.sop || packed);
+
+  // Words not associated with a packet are discarded.
+  if (!c.in_packet && !in.sop) return false;
+
+  out = Out{};
+  out.valid = true;
+  out.chan = in.chan;
+  out.sop = in.sop;
+  out.eop = (cur && in.eop) || (in.sop && in.eop && !packed);
+  out.sop_off = in.sop_off;
+  // Length is meaningful only on EOP; it crosses to the HOST clock
+  // domain alongside the verdict.
+  out.length = in.eop ? in.length : 0;
+  out.data = in.data;
+
+  if (cur) {
+    append(c, in.data, 0, in.eop ? in.length : 7);
+    if (in.eop) {
+      verdict(c, out);
+      c.in_packet = false;
+    }
+  }
+
+  if (in.sop) {
+    // Rule set is sampled on SOP.
+    c.rule = active_[in.rule];
+    c.bytes.clear();
+    if (in.eop && !packed) {
+      append(c, in.data, in.sop_off, in.length);
+      verdict(c, out);
+      c.in_packet = false;
+    } else {
+      append(c, in.data, in.sop_off, 7);
+      c.in_packet = true;
+    }
+  }
+  return true;
+}
+
+void Model::append(Context& c, vluint64_t data, std::size_t lo,
+                   std::size_t hi) {
+  for (std::size_t i = lo; i <= hi; i++) {
+    c.bytes.push_back(static_cast<std::uint8_t>(data >> (i * 8)));
+  }
+}
+
+void Model::verdict(const Context& c, Out& out) {
+  m::Packet p;
+  p.data = c.bytes.data();
+  p.bytes = c.bytes.size();
+  const m::Outcome o = matcher_.outcome(c.rule, p);
+
+  out.status.type_hit = o.type;
+  out.status.hit = o.hit;
+  out.status.slot = o.slot;
+  out.buffer = o.buffer;
+
+  stats_.packets++;
+  if (o.buffer != 0) { stats_.matched++; }
+}
+
+EgressModel::EgressModel(const EgressConfig& cfg) : cfg_(cfg) {}
+
+void EgressModel::predict(const Out& out, std::vector<Out>& delivered) {
+  if (cfg_.mode == EgressMode::Forward) {
+    if (out.eop) { stats_.delivered++; }
+    delivered.push_back(out);
+    return;
+  }
+
+  if (out.sop && out.eop && (out.sop_off > out.length)) {
+    // Packed word; the two packets may differ in outcome.
+    Out eop{out};
+    eop.sop = false;
+    push(eop, delivered);
+
+    Out sop{out};
+    sop.eop = false;
+    sop.length = 0;
+    sop.status = Status{};
+    sop.buffer = 0;
+    push(sop, delivered);
+    return;
+  }
+  push(out, delivered);
+}
+
+void EgressModel::push(const Out& out, std::vector<Out>& delivered) {
+  Packet& p{pkts_[out.chan]};
+
+  // A SOP discards the incomplete packet in progress (if any).
+  if (out.sop) {
+    p.words.clear();
+    p.drop = false;
+  }
+  if (p.drop) return;
+
+  if (p.words.size() >= std::min(cfg_.depth, EGRESS_N)) {
+    p.words.clear();
+    p.drop = true;
+    stats_.overflows++;
+    return;
+  }
+  p.words.push_back(out);
+
+  if (!out.eop) return;
+
+  const std::size_t keep =
+      (cfg_.mode == EgressMode::Truncate) ? cfg_.hdr : 0;
+  if ((out.buffer != 0) || (p.words.size() <= keep)) {
+    stats_.delivered++;
+  } else if (keep != 0) {
+    // Retained words are delivered; the final retained word ends the
+    // packet, without verdict but retaining the status of the packet.
+    p.words.resize(keep);
+    p.words.back().eop = true;
+    p.words.back().length = 7;
+    p.words.back().status = out.status;
+    p.words.back().buffer = 0;
+    stats_.delivered++;
+    stats_.truncated++;
+  } else {
+    p.words.clear();
+    stats_.filtered++;
+  }
+  delivered.insert(delivered.end(), p.words.begin(), p.words.end());
+  p.words.clear();
+}
+
+void CplModel::predict(const Out& out) {
+  Channel& c{chans_[out.chan]};
+
+  // Word ends the packet in progress and starts the next.
+  const bool packed = out.sop && out.eop && (out.sop_off > out.length);
+
+  if (out.sop && !packed) {
+    c.bytes = 8 - out.sop_off;
+    if (out.eop) { c.bytes = out.length + 1 - out.sop_off; }
+  } else if (out.eop) {
+    c.bytes += out.length + 1;
+  } else {
+    c.bytes += 8;
+  }
+
+  if (out.eop) {
+    Descriptor d;
+    d.chan = out.chan;
+    d.bytes = c.bytes;
+    d.status = out.status;
+    d.buffer = out.buffer;
+    c.pending.push_back(d);
+  }
+  if (packed) { c.bytes = 8 - out.sop_off; }
+}
+
+bool CplModel::pop(std::size_t chan, Descriptor& d) {
+  Channel& c{chans_[chan]};
+  if (c.pending.empty()) return false;
+
+  d = c.pending.front();
+  c.pending.pop_front();
+  return true;
+}
+
+} // namespace tb
@@ -0,0 +1,200 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_MODEL_H
+#define M_TB_MODEL_H
+
+#include "tb.h"
+#include "matcher.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace tb {
+
+// Rule set of a testcase as presented to the software matcher.
+m::Rule to_rule(const TestCase& tc);
+
+// Transaction-level reference model of the RTL. The egress is
+// predicted from the ingress as it is driven, against the rule sets
+// as they are configured; the verdict of each packet is computed by
+// the software matcher (sw/matcher.h). The model is therefore
+// independent of the source of stimulus.
+//
+class Model {
+ public:
+  struct Stats {
+    // Packets completed
+    std::size_t packets = 0;
+
+    // Packets completed with a non-zero verdict
+    std::size_t matched = 0;
+  };
+
+  Model();
+
+  // Write rule set 'idx'; the rule set becomes active upon commit.
+  void write(std::size_t idx, const m::Rule& rule);
+
+  // Written rule sets become active.
+  void commit();
+
+  // Predict the egress word corresponding to ingress word 'in';
+  // returns false where the word is not emitted.
+  bool predict(const In& in, Out& out);
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Packet in progress on a channel.
+  struct Context {
+    bool in_packet = false;
+    m::Rule rule;
+    std::vector<std::uint8_t> bytes;
+  };
+
+  // Append bytes [lo, hi] of 'data' to the packet in progress on
+  // context 'c'.
+  static void append(Context& c, vluint64_t data, std::size_t lo,
+                     std::size_t hi);
+
+  // Assign the status and verdict of the packet in progress on
+  // context 'c' to 'out'.
+  void verdict(const Context& c, Out& out);
+
+  // Rule table
+  std::array<m::Rule, RULE_N> active_;
+  std::array<m::Rule, RULE_N> written_;
+  std::bitset<RULE_N> dirty_;
+
+  // Packet in progress on each channel
+  std::array<Context, CHAN_N> ctx_;
+
+  m::Matcher matcher_;
+
+  Stats stats_;
+};
+
+// Transaction-level model of the egress stage (m_egress.sv); the
+// words predicted by Model are delivered to the host according to the
+// egress mode. Where packets are filtered, the words of a packet are
+// released on its EOP, and a packed word is delivered as the final
+// word of the packet in progress followed by the initial word of the
+// next.
+//
+// A packet with more words than the buffer depth is predicted to
+// overflow. Overflow due to the committed words of prior packets,
+// yet to be drained to the host, depends upon timing and is not
+// modelled; stimulus must avoid it.
+//
+class EgressModel {
+ public:
+  struct Stats {
+    // Packets delivered to the host (whole or truncated).
+    std::size_t delivered = 0;
+
+    // Packets delivered truncated.
+    std::size_t truncated = 0;
+
+    // Packets discarded by verdict.
+    std::size_t filtered = 0;
+
+    // Packets discarded on overflow of the buffer.
+    std::size_t overflows = 0;
+  };
+
+  explicit EgressModel(const EgressConfig& cfg = EgressConfig());
+
+  // Present predicted word 'out'; the words delivered to the host as
+  // a consequence are appended to 'delivered'.
+  void predict(const Out& out, std::vector<Out>& delivered);
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Present a word of a single packet to the buffer.
+  void push(const Out& out, std::vector<Out>& delivered);
+
+  // Packet in progress on a channel.
+  struct Packet {
+    // Words retained.
+    std::vector<Out> words;
+
+    // Packet has overflowed; discarded until the next SOP.
+    bool drop = false;
+  };
+
+  EgressConfig cfg_;
+
+  std::array<Packet, CHAN_N> pkts_;
+
+  Stats stats_;
+};
+
+// Transaction-level model of the completion engine (m_cpl.sv); a
+// descriptor is predicted for each packet delivered to the host, as
+// predicted by EgressModel. The order of descriptors amongst channels
+// depends upon the arbitration of the egress; descriptors are
+// therefore expected in order per channel.
+//
+class CplModel {
+ public:
+  CplModel() = default;
+
+  // Present word 'out' delivered to the host.
+  void predict(const Out& out);
+
+  // Retrieve the next descriptor expected on channel 'chan'; returns
+  // false where none is expected. The sequence number is not
+  // predicted.
+  bool pop(std::size_t chan, Descriptor& d);
+
+  // Flag denoting that all expected descriptors have been consumed.
+  bool drained() const {
+    return std::all_of(chans_.begin(), chans_.end(), [](const Channel& c) {
+      return c.pending.empty();
+    });
+  }
+
+ private:
+  struct Channel {
+    // Bytes delivered of the packet in progress.
+    vluint16_t bytes = 0;
+
+    // Descriptors expected, in order.
+    std::deque<Descriptor> pending;
+  };
+
+  std::array<Channel, CHAN_N> chans_;
+};
+
+} // namespace tb
+
+#endif
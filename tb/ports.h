@@ -0,0 +1,319 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_PORTS_H
+#define M_TB_PORTS_H
+
+#include "tb.h"
+#include "utility.h"
+#include "matcher.h"
+#include "Vobj/Vtb.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace tb {
+
+// Element widths of the flattened ports of the testbench top (see:
+// m_pkg.vh).
+inline constexpr std::size_t RULE_IDX_W = 3;
+inline constexpr std::size_t CHAN_W = 2;
+inline constexpr std::size_t LEN_W = 3;
+inline constexpr std::size_t DATA_W = 64;
+inline constexpr std::size_t BUFFER_W = 8;
+inline constexpr std::size_t PACKET_OFF_W = 11;
+inline constexpr std::size_t PACKET_TYPE_W = 32;
+inline constexpr std::size_t WORD_OFF_W = 8;
+inline constexpr std::size_t AFIFO_PTR_W = 5;
+inline constexpr std::size_t VFIFO_PTR_W = 4;
+inline constexpr std::size_t EGRESS_MODE_W = 2;
+inline constexpr std::size_t EGRESS_DEPTH_W = 16;
+inline constexpr std::size_t EGRESS_COUNT_W = 32;
+inline constexpr std::size_t STATUS_W = 4;
+inline constexpr std::size_t CPL_IDX_W = 6;
+inline constexpr std::size_t CPL_PTR_W = 7;
+inline constexpr std::size_t CPL_SEQ_W = 16;
+inline constexpr std::size_t CPL_BYTES_W = 16;
+inline constexpr std::size_t CPL_COUNT_W = 8;
+inline constexpr std::size_t CPL_TIMEOUT_W = 16;
+
+// Queue pointers carry an additional wrap bit.
+static_assert((std::size_t{1} << (AFIFO_PTR_W - 1)) == AFIFO_N);
+static_assert((std::size_t{1} << (VFIFO_PTR_W - 1)) == VFIFO_N);
+
+// Match status (m_pkg::status_t; 'type_hit' is the most significant).
+inline Status to_status(vluint64_t v) {
+  Status s;
+  s.type_hit = ((v >> 3) & 1) != 0;
+  s.hit = ((v >> 2) & 1) != 0;
+  s.slot = static_cast<vluint8_t>(v & 0x3);
+  return s;
+}
+
+inline vluint8_t from_status(const Status& s) {
+  return static_cast<vluint8_t>((s.type_hit ? 8 : 0) | (s.hit ? 4 : 0) |
+                                (s.slot & 0x3));
+}
+
+// Instance 'k' occupies element 'k' (of 'W' bits) of each port of the
+// testbench top. Verilator represents ports of up to 64b as integral
+// types, and wider ports as arrays of 32b words.
+template<std::size_t W, typename T>
+void put(T& port, std::size_t k, vluint64_t v) {
+  if constexpr (std::is_integral_v<T>) {
+    const T m = static_cast<T>(utility::mask<vluint64_t>(W) << (k * W));
+    port = (port & ~m) | (static_cast<T>(v << (k * W)) & m);
+  } else {
+    for (std::size_t b = 0; b < W; ) {
+      const std::size_t i = (k * W) + b;
+      const std::size_t n = std::min(32 - (i % 32), W - b);
+      const EData m = utility::mask<EData>(n) << (i % 32);
+      port[i / 32] = (port[i / 32] & ~m) |
+                     (static_cast<EData>(v >> b) << (i % 32) & m);
+      b += n;
+    }
+  }
+}
+
+template<std::size_t W, typename T>
+vluint64_t get(const T& port, std::size_t k) {
+  if constexpr (std::is_integral_v<T>) {
+    return (static_cast<vluint64_t>(port) >> (k * W)) &
+           utility::mask<vluint64_t>(W);
+  } else {
+    vluint64_t v = 0;
+    for (std::size_t b = 0; b < W; ) {
+      const std::size_t i = (k * W) + b;
+      const std::size_t n = std::min(32 - (i % 32), W - b);
+      const EData m = utility::mask<EData>(n);
+      v |= static_cast<vluint64_t>((port[i / 32] >> (i % 32)) & m) << b;
+      b += n;
+    }
+    return v;
+  }
+}
+
+struct InDriver {
+  static void drive(Vtb* tb, std::size_t k) {
+    drive(tb, k, In{});
+  }
+
+  static void drive(Vtb* tb, std::size_t k, const In& in) {
+    put<1>(tb->in_vld_w, k, in.valid);
+    put<CHAN_W>(tb->in_chan_w, k, in.chan);
+    put<RULE_IDX_W>(tb->in_rule_w, k, in.rule);
+    put<1>(tb->in_sop_w, k, in.sop);
+    put<1>(tb->in_eop_w, k, in.eop);
+    put<LEN_W>(tb->in_sop_off_w, k, in.sop_off);
+    put<LEN_W>(tb->in_length_w, k, in.length);
+    put<DATA_W>(tb->in_data_w, k, in.data);
+  }
+
+  // The word driven is accepted on the next NET clock edge; otherwise,
+  // it must be driven again.
+  static bool ready(Vtb* tb, std::size_t k) {
+    return get<1>(tb->in_rdy_w, k) != 0;
+  }
+};
+
+struct OutMonitor {
+  static Out get(Vtb* tb, std::size_t k) {
+    Out out;
+    out.valid = tb::get<1>(tb->out_vld_r, k);
+    out.chan = tb::get<CHAN_W>(tb->out_chan_r, k);
+    out.sop = tb::get<1>(tb->out_sop_r, k);
+    out.eop = tb::get<1>(tb->out_eop_r, k);
+    out.sop_off = tb::get<LEN_W>(tb->out_sop_off_r, k);
+    out.length = tb::get<LEN_W>(tb->out_length_r, k);
+    out.data = tb::get<DATA_W>(tb->out_data_r, k);
+    out.status = to_status(tb::get<STATUS_W>(tb->out_status_r, k));
+    out.buffer = tb::get<BUFFER_W>(tb->out_buffer_r, k);
+    return out;
+  }
+};
+
+// Egress configuration (static) and overflow accounting.
+struct EgressDriver {
+  static void drive(Vtb* tb, std::size_t k, const EgressConfig& cfg) {
+    put<EGRESS_MODE_W>(tb->cfg_egress_mode_w, k,
+                       static_cast<vluint64_t>(cfg.mode));
+    put<WORD_OFF_W>(tb->cfg_egress_hdr_w, k, cfg.hdr);
+    put<EGRESS_DEPTH_W>(tb->cfg_egress_depth_w, k, cfg.depth);
+  }
+
+  // Packets discarded on overflow of the egress buffer.
+  static std::size_t overflows(Vtb* tb, std::size_t k) {
+    return get<EGRESS_COUNT_W>(tb->out_overflows_r, k);
+  }
+};
+
+// Completion ring configuration (static), consumer interface and
+// overflow accounting.
+struct CplDriver {
+  static void drive(Vtb* tb, std::size_t k, const CplConfig& cfg) {
+    put<CPL_COUNT_W>(tb->cfg_cpl_count_w, k, cfg.count);
+    put<CPL_TIMEOUT_W>(tb->cfg_cpl_timeout_w, k, cfg.timeout);
+  }
+
+  // Return descriptors up to (excluding) 'cons', and present the
+  // descriptor at 'cons' on the read port.
+  static void consume(Vtb* tb, std::size_t k, std::size_t cons) {
+    put<CPL_PTR_W>(tb->cpl_cons_w, k, cons);
+    put<CPL_IDX_W>(tb->cpl_rd_idx_w, k, cons % CPL_N);
+  }
+
+  // Descriptor presented on the read port.
+  static Descriptor read(Vtb* tb, std::size_t k) {
+    Descriptor d;
+    d.seq = get<CPL_SEQ_W>(tb->cpl_rd_seq_w, k);
+    d.chan = get<CHAN_W>(tb->cpl_rd_chan_w, k);
+    d.bytes = get<CPL_BYTES_W>(tb->cpl_rd_bytes_w, k);
+    d.status = to_status(get<STATUS_W>(tb->cpl_rd_status_w, k));
+    d.buffer = get<BUFFER_W>(tb->cpl_rd_buffer_w, k);
+    return d;
+  }
+
+  // Producer pointer (carries an additional wrap bit).
+  static std::size_t prod(Vtb* tb, std::size_t k) {
+    return get<CPL_PTR_W>(tb->cpl_prod_r, k);
+  }
+
+  // Notification raised.
+  static bool irq(Vtb* tb, std::size_t k) {
+    return get<1>(tb->cpl_irq_r, k);
+  }
+
+  // Descriptors discarded on overflow of the ring.
+  static std::size_t overflows(Vtb* tb, std::size_t k) {
+    return get<EGRESS_COUNT_W>(tb->cpl_overflows_r, k);
+  }
+};
+
+// Clock-crossing queue state; visible by way of the queue state ports
+// of the testbench top.
+struct QueueMonitor {
+  struct State {
+    // Queue is pushed on the next NET clock edge.
+    bool push;
+
+    // Current number of entries in the queue.
+    std::size_t occupancy;
+  };
+
+  // Data path (m.sv: u_async_queue)
+  static State afifo(Vtb* tb, std::size_t k) {
+    return State{get<1>(tb->afifo_push_w, k) != 0,
+                 occupancy<AFIFO_N, AFIFO_PTR_W>(
+                     tb->afifo_wptr_r, tb->afifo_rptr_r, k)};
+  }
+
+  // Verdict path (m.sv: u_verdict_queue)
+  static State vfifo(Vtb* tb, std::size_t k) {
+    return State{get<1>(tb->vfifo_push_w, k) != 0,
+                 occupancy<VFIFO_N, VFIFO_PTR_W>(
+                     tb->vfifo_wptr_r, tb->vfifo_rptr_r, k)};
+  }
+
+  // Queue dimensions of the testbench must correspond to those of the
+  // RTL (m_pkg).
+  static void check(Vtb* tb) {
+    EXPECT_EQ(tb->afifo_n_w, AFIFO_N);
+    EXPECT_EQ(tb->afifo_bits_w, AFIFO_W);
+    EXPECT_EQ(tb->vfifo_n_w, VFIFO_N);
+    EXPECT_EQ(tb->vfifo_bits_w, VFIFO_W);
+    EXPECT_EQ(tb->out_bits_w, OUT_W);
+  }
+
+  // Record a push into a queue of depth 'n'; a push into a full queue
+  // is lost.
+  static void record(const State& s, std::size_t n,
+                     std::size_t& high_water, std::size_t& overflows) {
+    if (!s.push) return;
+
+    if (s.occupancy >= n) { overflows++; }
+    high_water = std::max(high_water, s.occupancy + 1);
+  }
+
+ private:
+  template<std::size_t N, std::size_t W, typename T>
+  static std::size_t occupancy(const T& wptr, const T& rptr, std::size_t k) {
+    // Pointers carry an additional wrap bit.
+    return (get<W>(wptr, k) - get<W>(rptr, k)) & ((2 * N) - 1);
+  }
+};
+
+struct RuleDriver {
+  static void drive(Vtb* tb, std::size_t k) {
+    put<1>(tb->cfg_vld_w, k, false);
+    put<RULE_IDX_W>(tb->cfg_idx_w, k, 0);
+    put<1>(tb->cfg_commit_w, k, false);
+  }
+
+  static void commit(Vtb* tb, std::size_t k) {
+    put<1>(tb->cfg_commit_w, k, true);
+  }
+
+  static bool busy(Vtb* tb, std::size_t k) {
+    return get<1>(tb->cfg_busy_r, k);
+  }
+
+  static void drive(Vtb* tb, std::size_t k, std::size_t idx,
+                    const m::Rule& r) {
+    put<1>(tb->cfg_vld_w, k, true);
+    put<RULE_IDX_W>(tb->cfg_idx_w, k, idx);
+    put<PACKET_OFF_W>(tb->cfg_type_off_w, k, r.type_off);
+    put<PACKET_TYPE_W>(tb->cfg_type_w, k, r.type);
+    put<1>(tb->cfg_sym_anywhere_w, k, r.symbol_anywhere);
+
+    const std::array<m::Symbol, 4>& ms{r.symbol};
+
+    put<1>(tb->cfg_match0_vld_w, k, ms[0].valid);
+    put<WORD_OFF_W>(tb->cfg_match0_off_w, k, ms[0].off);
+    put<DATA_W>(tb->cfg_match0_match_w, k, ms[0].match);
+    put<BUFFER_W>(tb->cfg_match0_buffer_w, k, ms[0].buffer);
+
+    put<1>(tb->cfg_match1_vld_w, k, ms[1].valid);
+    put<WORD_OFF_W>(tb->cfg_match1_off_w, k, ms[1].off);
+    put<DATA_W>(tb->cfg_match1_match_w, k, ms[1].match);
+    put<BUFFER_W>(tb->cfg_match1_buffer_w, k, ms[1].buffer);
+
+    put<1>(tb->cfg_match2_vld_w, k, ms[2].valid);
+    put<WORD_OFF_W>(tb->cfg_match2_off_w, k, ms[2].off);
+    put<DATA_W>(tb->cfg_match2_match_w, k, ms[2].match);
+    put<BUFFER_W>(tb->cfg_match2_buffer_w, k, ms[2].buffer);
+
+    put<1>(tb->cfg_match3_vld_w, k, ms[3].valid);
+    put<WORD_OFF_W>(tb->cfg_match3_off_w, k, ms[3].off);
+    put<DATA_W>(tb->cfg_match3_match_w, k, ms[3].match);
+    put<BUFFER_W>(tb->cfg_match3_buffer_w, k, ms[3].buffer);
+  }
+};
+
+} // namespace tb
+
+#endif
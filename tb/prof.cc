@@ -0,0 +1,118 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "prof.h"
+#include <cstdio>
+#include <cstring>
+
+namespace tb::prof {
+
+const char* to_string(Section s) {
+  switch (s) {
+    case Section::Generate: return "generate";
+    case Section::Construct: return "construct";
+    case Section::Eval: return "eval";
+    case Section::Trace: return "trace";
+    case Section::NetDrive: return "net_drive";
+    case Section::HostSample: return "host_sample";
+    case Section::Complete: return "complete";
+    default: break;
+  }
+  return "unknown";
+}
+
+Profile& Profile::local() {
+  static thread_local Profile profile;
+  return profile;
+}
+
+void Profile::begin(const std::string& label) {
+  if (depth_++ != 0) return;
+
+  runs_.emplace_back();
+  runs_.back().label = label;
+}
+
+void Profile::end(std::uint64_t ns) {
+  if (--depth_ != 0) return;
+
+  runs_.back().total = ns;
+}
+
+// File format; per run, a header line followed by one line per
+// section:
+//
+//   run <total ns> <label>
+//   <section> <calls> <ns>
+//
+bool Profile::dump(const char* fn) const {
+  std::FILE* f = std::fopen(fn, "w");
+  if (f == nullptr) return false;
+
+  for (const Run& r : runs_) {
+    std::fprintf(f, "run %llu %s\n", static_cast<unsigned long long>(r.total),
+                 r.label.c_str());
+    for (std::size_t i = 0; i < Run::N; i++) {
+      std::fprintf(f, "%s %llu %llu\n", to_string(static_cast<Section>(i)),
+                   static_cast<unsigned long long>(r.calls[i]),
+                   static_cast<unsigned long long>(r.ns[i]));
+    }
+  }
+  std::fclose(f);
+  return true;
+}
+
+bool Profile::load(const char* fn, std::vector<Run>& runs) {
+  std::FILE* f = std::fopen(fn, "r");
+  if (f == nullptr) return false;
+
+  char line[512];
+  while (std::fgets(line, sizeof(line), f) != nullptr) {
+    line[std::strcspn(line, "\n")] = '\0';
+
+    unsigned long long a, b;
+    char name[64];
+    int n = 0;
+    if (std::sscanf(line, "run %llu %n", &a, &n) == 1) {
+      runs.emplace_back();
+      runs.back().total = a;
+      runs.back().label = line + n;
+    } else if (!runs.empty() &&
+               (std::sscanf(line, "%63s %llu %llu", name, &a, &b) == 3)) {
+      for (std::size_t i = 0; i < Run::N; i++) {
+        if (std::strcmp(name, to_string(static_cast<Section>(i))) == 0) {
+          runs.back().calls[i] = a;
+          runs.back().ns[i] = b;
+        }
+      }
+    }
+  }
+  std::fclose(f);
+  return true;
+}
+
+} // namespace tb::prof
@@ -0,0 +1,158 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_PROF_H
+#define M_TB_PROF_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tb::prof {
+
+// Profiled phases of a run.
+enum class Section : std::uint8_t {
+  // Stimulus generation (RegressEnvironment::build).
+  Generate,
+
+  // Construction of the testbench and the Verilated model.
+  Construct,
+
+  // Evaluation of the Verilated model (Vtb::eval).
+  Eval,
+
+  // Waveform tracing.
+  Trace,
+
+  // Stimulus issue and prediction (TB::on_net_clk_negedge).
+  NetDrive,
+
+  // Rule set programming and egress checks (TB::on_host_clk_negedge).
+  HostSample,
+
+  // Checks upon completion of a run.
+  Complete,
+
+  // Number of sections.
+  N
+};
+
+// Name of section 's'.
+const char* to_string(Section s);
+
+// Time (ns) and invocations attributed to each section of a run. Time
+// not attributed to any section is the testbench loop itself.
+struct Run {
+  static constexpr std::size_t N = static_cast<std::size_t>(Section::N);
+
+  std::string label;
+  std::uint64_t total = 0;
+  std::array<std::uint64_t, N> ns{};
+  std::array<std::uint64_t, N> calls{};
+};
+
+// Per-thread profile; the runs completed by the thread. Sections are
+// accumulated into the run in progress (if any) at the cost of two
+// reads of the monotonic clock; runs may nest, in which case time is
+// attributed to the outermost.
+//
+class Profile {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Profile of the calling thread.
+  static Profile& local();
+
+  // Open a run, 'label'.
+  void begin(const std::string& label);
+
+  // Close the run opened by the matching begin; 'ns' elapsed.
+  void end(std::uint64_t ns);
+
+  // Attribute 'ns' to section 's' of the run in progress.
+  void add(Section s, std::uint64_t ns) {
+    if (depth_ == 0) return;
+    const std::size_t i = static_cast<std::size_t>(s);
+    runs_.back().ns[i] += ns;
+    runs_.back().calls[i]++;
+  }
+
+  // Completed runs.
+  const std::vector<Run>& runs() const { return runs_; }
+
+  // Write completed runs to file 'fn' (text; see: profreport).
+  bool dump(const char* fn) const;
+
+  // Read runs from file 'fn' as written by dump.
+  static bool load(const char* fn, std::vector<Run>& runs);
+
+ private:
+  Profile() = default;
+
+  std::vector<Run> runs_;
+  std::size_t depth_ = 0;
+};
+
+// Attribute the lifetime of the scope to section 's'.
+class Scope {
+ public:
+  explicit Scope(Section s) : s_(s), start_(Profile::Clock::now()) {}
+
+  ~Scope() {
+    const auto d = Profile::Clock::now() - start_;
+    Profile::local().add(
+        s_, std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+  }
+
+ private:
+  Section s_;
+  Profile::Clock::time_point start_;
+};
+
+// Attribute the lifetime of the scope to a run, 'label'.
+class RunScope {
+ public:
+  explicit RunScope(const std::string& label)
+      : start_(Profile::Clock::now()) {
+    Profile::local().begin(label);
+  }
+
+  ~RunScope() {
+    const auto d = Profile::Clock::now() - start_;
+    Profile::local().end(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+  }
+
+ private:
+  Profile::Clock::time_point start_;
+};
+
+} // namespace tb::prof
+
+#endif
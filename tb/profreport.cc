@@ -0,0 +1,250 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+// Merge the phase profile of the testbench (see: prof.h) with the
+// function profile of the driver (gprof; the Verilated model is built
+// with --prof-cfuncs) into a hotspot breakdown per run. The function
+// profile spans the process; time evaluating the model is apportioned
+// to its functions by their share of the model's self time. Reports
+// of the Verilator tools, where given, are appended verbatim.
+//
+//   profreport <driver.prof> [driver.gprof [profcfunc [gantt]]]
+//
+
+#include "prof.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using tb::prof::Run;
+using tb::prof::Section;
+
+// Function of the gprof flat profile.
+struct Function {
+  std::string name;
+  double self = 0;
+};
+
+// Origin of a function.
+enum class Group {
+  Model,
+  Runtime,
+  Testbench,
+  Matcher,
+  Gtest,
+  Other,
+  N
+};
+
+const char* to_string(Group g) {
+  switch (g) {
+    case Group::Model: return "model";
+    case Group::Runtime: return "verilator";
+    case Group::Testbench: return "testbench";
+    case Group::Matcher: return "matcher";
+    case Group::Gtest: return "gtest";
+    default: break;
+  }
+  return "other";
+}
+
+Group classify(const std::string& name) {
+  auto prefix = [&](const char* p) { return name.rfind(p, 0) == 0; };
+  // Verilated model classes are prefixed by the top-level (tb.sv).
+  if (prefix("Vtb")) return Group::Model;
+  if (prefix("Verilated") || prefix("Vl") || prefix("VL_") ||
+      prefix("vl_")) {
+    return Group::Runtime;
+  }
+  if (prefix("tb::") || prefix("TestcaseBuilder") ||
+      prefix("RegressEnvironment")) {
+    return Group::Testbench;
+  }
+  if (prefix("m::")) return Group::Matcher;
+  if (prefix("testing::")) return Group::Gtest;
+  return Group::Other;
+}
+
+// Parse the flat profile of gprof output 'fn'; rows are of the form:
+//
+//   %time cumulative self [calls self/call total/call] name
+//
+bool load_gprof(const char* fn, std::vector<Function>& fs) {
+  std::ifstream is{fn};
+  if (!is) return false;
+
+  std::string line;
+  while (std::getline(is, line) && (line.rfind("Flat profile:", 0) != 0)) {}
+  // Skip to the column headings.
+  while (std::getline(is, line) && (line.find(" time ") == std::string::npos)) {}
+  while (std::getline(is, line) && !line.empty()) {
+    std::istringstream ss{line};
+    std::vector<std::string> tokens;
+    for (std::string t; ss >> t;) { tokens.push_back(t); }
+    if (tokens.size() < 4) continue;
+
+    // Numeric columns precede the (possibly spaced) name.
+    std::size_t i = 0;
+    while ((i < std::min<std::size_t>(tokens.size() - 1, 6)) &&
+           (tokens[i].find_first_not_of("0123456789.") == std::string::npos)) {
+      i++;
+    }
+    if (i < 3) continue;
+
+    Function f;
+    f.self = std::stod(tokens[2]);
+    for (std::size_t j = i; j < tokens.size(); j++) {
+      f.name += (j == i) ? tokens[j] : (" " + tokens[j]);
+    }
+    fs.push_back(f);
+  }
+  return true;
+}
+
+void append(const char* title, const char* fn) {
+  std::ifstream is{fn};
+  if (!is) {
+    std::cerr << "Cannot open: " << fn << "\n";
+    return;
+  }
+  std::cout << "\n" << title << " (" << fn << ")\n\n" << is.rdbuf();
+}
+
+double share(double ns, double total) {
+  return (total > 0) ? (100.0 * ns / total) : 0.0;
+}
+
+void print_row(const char* name, std::uint64_t calls, double ns,
+               double total) {
+  char buf[128];
+  std::snprintf(buf, sizeof(buf), "  %-14s %12s %12.3f %6.1f%%\n", name,
+                (calls != 0) ? std::to_string(calls).c_str() : "",
+                ns * 1e-6, share(ns, total));
+  std::cout << buf;
+}
+
+// Function 'name', its time and share, indented beneath a row.
+void print_function(const std::string& name, double ns, double total) {
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "  %27s %12.3f %6.1f%%  ", "", ns * 1e-6,
+                share(ns, total));
+  std::cout << buf << name << "\n";
+}
+
+// Hotspots of the model reported within the evaluation of each run.
+constexpr std::size_t MODEL_HOTSPOT_N = 5;
+
+// Hotspots of the process.
+constexpr std::size_t HOTSPOT_N = 10;
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if ((argc < 2) || (argc > 5)) {
+    std::cerr << "usage: " << argv[0]
+              << " <driver.prof> [driver.gprof [profcfunc [gantt]]]\n";
+    return 1;
+  }
+
+  std::vector<Run> runs;
+  if (!tb::prof::Profile::load(argv[1], runs)) {
+    std::cerr << "Cannot open: " << argv[1] << "\n";
+    return 1;
+  }
+
+  std::vector<Function> fs;
+  if ((argc > 2) && !load_gprof(argv[2], fs)) {
+    std::cerr << "Cannot open: " << argv[2] << "\n";
+    return 1;
+  }
+  std::sort(fs.begin(), fs.end(), [](const Function& a, const Function& b) {
+    return a.self > b.self;
+  });
+
+  // Self time of the model, by which evaluation is apportioned.
+  double model_self = 0;
+  std::vector<const Function*> model;
+  for (const Function& f : fs) {
+    if (classify(f.name) != Group::Model) continue;
+    model_self += f.self;
+    model.push_back(&f);
+  }
+
+  for (const Run& r : runs) {
+    std::cout << "run " << r.label << " (" << (r.total * 1e-9) << " s)\n";
+    std::cout << "  section               calls    time (ms)   share\n";
+    std::uint64_t attributed = 0;
+    for (std::size_t i = 0; i < Run::N; i++) {
+      if (r.calls[i] == 0) continue;
+
+      print_row(tb::prof::to_string(static_cast<Section>(i)), r.calls[i],
+                r.ns[i], r.total);
+      attributed += r.ns[i];
+      if ((static_cast<Section>(i) == Section::Eval) && (model_self > 0)) {
+        for (std::size_t j = 0; j < std::min(model.size(), MODEL_HOTSPOT_N);
+             j++) {
+          const Function& f{*model[j]};
+          print_function(f.name, r.ns[i] * (f.self / model_self), r.total);
+        }
+      }
+    }
+    // Remainder is the testbench loop itself.
+    const std::uint64_t rest =
+        (r.total > attributed) ? (r.total - attributed) : 0;
+    print_row("(loop)", 0, rest, r.total);
+    std::cout << "\n";
+  }
+
+  if (!fs.empty()) {
+    double total = 0;
+    double group[static_cast<std::size_t>(Group::N)] = {};
+    for (const Function& f : fs) {
+      total += f.self;
+      group[static_cast<std::size_t>(classify(f.name))] += f.self;
+    }
+
+    std::cout << "process (gprof self time: " << total << " s)\n";
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Group::N); i++) {
+      print_row(to_string(static_cast<Group>(i)), 0, group[i] * 1e9,
+                total * 1e9);
+    }
+    std::cout << "  hotspots:\n";
+    for (std::size_t i = 0; i < std::min(fs.size(), HOTSPOT_N); i++) {
+      print_function(fs[i].name, fs[i].self * 1e9, total * 1e9);
+    }
+  }
+
+  if (argc > 3) { append("Model by RTL source", argv[3]); }
+  if (argc > 4) { append("Model execution", argv[4]); }
+  return 0;
+}
@@ -0,0 +1,124 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_QUEUE_H
+#define M_TB_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace tb {
+
+// Bounded, lock-free, multi-producer/multi-consumer queue. Each slot
+// carries a sequence number which indicates whether the slot is free
+// for the producer of a given position, or full for the consumer of
+// that position; producers (consumers) claim positions by CAS on the
+// tail (head). Capacity is rounded up to a power of two.
+//
+template<typename T>
+class MpmcQueue {
+  struct Slot {
+    std::atomic<std::size_t> seq;
+    T value;
+  };
+
+ public:
+  explicit MpmcQueue(std::size_t n) {
+    std::size_t c = 2;
+    while (c < n) { c <<= 1; }
+    mask_ = c - 1;
+    slots_ = std::make_unique<Slot[]>(c);
+    for (std::size_t i = 0; i < c; i++) {
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  std::size_t capacity() const { return mask_ + 1; }
+
+  // Enqueue 'v'; false (and 'v' is untouched) where the queue is full.
+  bool push(T& v) {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& s{slots_[pos & mask_]};
+      const std::size_t seq = s.seq.load(std::memory_order_acquire);
+      const std::ptrdiff_t d = static_cast<std::ptrdiff_t>(seq - pos);
+      if (d == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          s.value = std::move(v);
+          s.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (d < 0) {
+        // Slot not yet released by the consumer of the prior lap.
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Dequeue into 'v'; false where the queue is empty.
+  bool pop(T& v) {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& s{slots_[pos & mask_]};
+      const std::size_t seq = s.seq.load(std::memory_order_acquire);
+      const std::ptrdiff_t d = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (d == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          v = std::move(s.value);
+          s.seq.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (d < 0) {
+        // Slot not yet filled by the producer of this lap.
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  // Producer and consumer positions on separate cache lines.
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  alignas(64) std::atomic<std::size_t> head_{0};
+
+  std::size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+};
+
+} // namespace tb
+
+#endif
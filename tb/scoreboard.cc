@@ -0,0 +1,170 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "scoreboard.h"
+#ifdef OPT_LOGGING_ENABLE
+#  include "log.h"
+#endif
+#include "gtest/gtest.h"
+
+namespace tb {
+
+template<typename F>
+void Scoreboard::split(const Out& out, F&& f) {
+  if (out.sop && out.eop && (out.sop_off > out.length)) {
+    // Packed beat; split into the EOP of the packet in progress and
+    // the SOP of the next.
+    Out eop{out};
+    eop.sop = false;
+    f(eop);
+
+    Out sop{out};
+    sop.eop = false;
+    f(sop);
+    return;
+  }
+  f(out);
+}
+
+void Scoreboard::predict(const Out& out) {
+  split(out, [this](const Out& o) { predict_packet(o); });
+}
+
+void Scoreboard::predict_packet(const Out& out) {
+  Channel& c{chans_[out.chan]};
+  c.predicted_digest = fold(c.predicted_digest, out);
+  c.predicted.push_back(out);
+
+  if (!out.eop) return;
+
+  Pending p;
+  p.id = predicted_n_++;
+  p.digest = c.predicted_digest;
+  p.out = std::move(c.predicted);
+  c.pending.push_back(std::move(p));
+
+  c.predicted_digest = 0;
+  c.predicted.clear();
+}
+
+void Scoreboard::observe(const Out& out, vluint64_t time) {
+  stats_.digest = fold(stats_.digest, out);
+  split(out, [this, time](const Out& o) { observe_packet(o, time); });
+}
+
+void Scoreboard::observe_packet(const Out& out, vluint64_t time) {
+  ASSERT_LT(out.chan, CHAN_N) << "Unexpected channel";
+  Channel& c{chans_[out.chan]};
+
+  // Error out immediately if receiving unexpected output. The beats
+  // of a packet may be observed before the packet has been predicted
+  // in its entirety.
+  ASSERT_TRUE(!c.pending.empty() || (c.actual.size() < c.predicted.size()))
+      << "Unexpected output beat; channel:" << static_cast<int>(out.chan);
+
+  c.digest = fold(c.digest, out);
+  c.actual.push_back(out);
+  stats_.beats++;
+
+  if (!out.eop) return;
+
+  ASSERT_FALSE(c.pending.empty())
+      << "Unexpected EOP; channel:" << static_cast<int>(out.chan);
+
+  const Pending& p{c.pending.front()};
+  if ((c.digest != p.digest) || (c.actual.size() != p.out.size())) {
+    stats_.mismatches++;
+#ifdef OPT_LOGGING_ENABLE
+    if (logging_enable_) {
+      log::Record& r = log::EventLog::local().push();
+      r = log::Record{time, log::Event::Mismatch, 0, 0, 0,
+                      static_cast<std::uint32_t>(c.actual.size()), p.id,
+                      c.digest};
+    }
+#endif
+    diff(p.id, p.out, c.actual);
+  }
+  stats_.packets++;
+  c.pending.pop_front();
+
+  c.digest = 0;
+  c.actual.clear();
+}
+
+std::uint64_t Scoreboard::fold(std::uint64_t h, const Out& out) {
+  auto mix = [](std::uint64_t h, std::uint64_t x) {
+    h = (h ^ x) * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 32);
+  };
+  std::uint64_t flags = (out.sop ? 1 : 0) | (out.eop ? 2 : 0);
+  flags |= (static_cast<std::uint64_t>(out.chan) << 24);
+  if (out.sop) {
+    // Start offset is only considered when SOP is valid.
+    flags |= (static_cast<std::uint64_t>(out.sop_off) << 4);
+  }
+  if (out.eop) {
+    // Length, status and buffer are only considered when EOP is
+    // valid.
+    flags |= (static_cast<std::uint64_t>(out.length) << 8);
+    flags |= (static_cast<std::uint64_t>(out.buffer) << 16);
+    flags |= (static_cast<std::uint64_t>(out.status.type_hit) << 32);
+    flags |= (static_cast<std::uint64_t>(out.status.hit) << 33);
+    flags |= (static_cast<std::uint64_t>(out.status.slot) << 34);
+  }
+  return mix(mix(h, flags), out.data);
+}
+
+void Scoreboard::diff(std::size_t id, const std::vector<Out>& expected,
+                      const std::vector<Out>& actual) {
+  EXPECT_EQ(expected.size(), actual.size()) << "packet:" << id;
+
+  const std::size_t n = std::min(expected.size(), actual.size());
+  for (std::size_t i = 0; i < n; i++) {
+    const Out& e{expected[i]};
+    const Out& a{actual[i]};
+    EXPECT_EQ(e.sop, a.sop) << "packet:" << id << " beat:" << i;
+    EXPECT_EQ(e.eop, a.eop) << "packet:" << id << " beat:" << i;
+    EXPECT_EQ(e.data, a.data) << "packet:" << id << " beat:" << i;
+    if (e.sop) {
+      // Start offset is only considered when SOP is valid.
+      EXPECT_EQ(e.sop_off, a.sop_off) << "packet:" << id << " beat:" << i;
+    }
+    if (e.eop) {
+      // Length, status and buffer are only considered when EOP is
+      // valid.
+      EXPECT_EQ(e.length, a.length) << "packet:" << id << " beat:" << i;
+      EXPECT_EQ(e.buffer, a.buffer) << "packet:" << id << " beat:" << i;
+      EXPECT_EQ(e.status.type_hit, a.status.type_hit)
+          << "packet:" << id << " beat:" << i;
+      EXPECT_EQ(e.status.hit, a.status.hit) << "packet:" << id << " beat:" << i;
+      EXPECT_EQ(e.status.slot, a.status.slot)
+          << "packet:" << id << " beat:" << i;
+    }
+  }
+}
+
+} // namespace tb
@@ -0,0 +1,148 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_SCOREBOARD_H
+#define M_TB_SCOREBOARD_H
+
+#include "tb.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace tb {
+
+// Streaming scoreboard; each packet observed at the egress is folded
+// into a running digest which is compared once, on EOP, against the
+// digest of the packet predicted by the reference model. The beats are compared
+// individually only on a digest mismatch, to localize the failure.
+//
+// A packed beat (ending one packet and starting the next) is observed
+// as the final beat of the first packet and the initial beat of the
+// second.
+//
+// Packets of distinct channels may be interleaved; packets are
+// tracked, and expected in order, per channel.
+//
+class Scoreboard {
+ public:
+  struct Stats {
+    // Packets checked
+    std::size_t packets = 0;
+
+    // Beats checked
+    std::size_t beats = 0;
+
+    // Packets for which the observed digest did not match.
+    std::size_t mismatches = 0;
+
+    // Digest of all observed beats, in order.
+    std::uint64_t digest = 0;
+  };
+
+  // Mismatches are recorded to the event log where 'logging_enable'.
+  explicit Scoreboard(bool logging_enable = false)
+      : logging_enable_(logging_enable) {}
+
+  // Register a predicted (valid) beat.
+  void predict(const Out& out);
+
+  // Observe a valid beat emitted by the RTL at simulation time 'time'.
+  void observe(const Out& out, vluint64_t time);
+
+  // Flag denoting that all expected packets have been observed.
+  bool drained() const {
+    return std::all_of(chans_.begin(), chans_.end(), [](const Channel& c) {
+      return c.pending.empty() && c.actual.empty() && c.predicted.empty();
+    });
+  }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Fold a single beat into digest 'h'.
+  static std::uint64_t fold(std::uint64_t h, const Out& out);
+
+  // Predict a beat of a single packet.
+  void predict_packet(const Out& out);
+
+  // Observe a beat of a single packet.
+  void observe_packet(const Out& out, vluint64_t time);
+
+  // Split packed beat 'out' into the final beat of the packet in
+  // progress and the initial beat of the next, applying 'f' to each.
+  template<typename F>
+  static void split(const Out& out, F&& f);
+
+  // Beat-by-beat comparison of a packet (on mismatch).
+  static void diff(std::size_t id, const std::vector<Out>& expected,
+                   const std::vector<Out>& actual);
+
+  struct Pending {
+    // Packet identifier (in order of prediction)
+    std::size_t id;
+
+    // Predicted digest
+    std::uint64_t digest;
+
+    // Predicted output; retained only until observed, for diagnosis
+    // on mismatch.
+    std::vector<Out> out;
+  };
+
+  struct Channel {
+    // Packets expected at the egress, in order.
+    std::deque<Pending> pending;
+
+    // Running digest of the packet currently predicted.
+    std::uint64_t predicted_digest = 0;
+
+    // Beats of the packet currently predicted.
+    std::vector<Out> predicted;
+
+    // Running digest of the current packet.
+    std::uint64_t digest = 0;
+
+    // Beats of the current packet (capacity retained across packets).
+    std::vector<Out> actual;
+  };
+
+  std::array<Channel, CHAN_N> chans_;
+
+  // Number of packets predicted.
+  std::size_t predicted_n_ = 0;
+
+  Stats stats_;
+
+  bool logging_enable_;
+};
+
+} // namespace tb
+
+#endif
@@ -27,33 +27,63 @@
 
 #include "tb.h"
 #include "utility.h"
-#include "Vobj/Vtb.h"
+#include "scoreboard.h"
+#include "model.h"
+#include "ports.h"
+#ifdef OPT_LOGGING_ENABLE
+#  include "log.h"
+#endif
 #ifdef OPT_VCD_ENABLE
 #  include "verilated_vcd_c.h"
 #endif
+#ifdef OPT_PROF_ENABLE
+#  include "prof.h"
+#endif
 #include "gtest/gtest.h"
+#include <array>
 #include <sstream>
 #include <iostream>
 
 namespace tb {
 
+#ifdef OPT_PROF_ENABLE
+namespace {
+
+// Profile label of a run; the current test (if any).
+std::string run_label() {
+  const testing::TestInfo* ti =
+      testing::UnitTest::GetInstance()->current_test_info();
+  if (ti == nullptr) return "run";
+  return std::string{ti->test_suite_name()} + "." + ti->name();
+}
+
+} // namespace
+#endif
+
+namespace {
+
+// Events are recorded to the event log under options 'opts'.
+bool logging_enabled(const Options& opts) {
+#ifdef OPT_LOGGING_ENABLE
+  return opts.logging_enable;
+#else
+  return false;
+#endif
+}
+
+} // namespace
+
 std::string TestCase::to_string() const {
   using std::to_string;
   
   utility::KVListRenderer r;
   r.add_field("id", to_string(id));
   r.add_field("bytes", to_string(bytes));
-  r.add_field("should_match", to_string(should_match));
-  if (should_match) {
-    r.add_field("predicted_match", utility::Hexer{}.to_hex(predicted_match));
-  }
   return r.to_string();
 }
 
 void Random::init(unsigned seed) {
-#ifdef OPT_LOGGING_ENABLE
-  std::cout << "[RND] seed set to " << seed << "\n";
-#endif
+  seed_ = seed;
   mt_ = std::mt19937{seed};
 }
 
@@ -62,105 +92,45 @@ bool Random::boolean(double true_prob) {
   return d(mt_);
 }
 
-struct InDriver {
-  static void drive(Vtb* tb) {
-    drive(tb, In{});
-  }
-
-  static void drive(Vtb* tb, const In& in) {
-    tb->in_vld_w = in.valid;
-    tb->in_sop_w = in.sop;
-    tb->in_eop_w = in.eop;
-    tb->in_length_w = in.length;
-    tb->in_data_w = in.data;
-  }
-};
-
-struct OutMonitor {
-  static Out get(Vtb* tb) {
-    Out out;
-    out.valid = tb->out_vld_r;
-    out.sop = tb->out_sop_r;
-    out.eop = tb->out_eop_r;
-    out.length = tb->out_length_r;
-    out.data = tb->out_data_r;
-    out.buffer = tb->out_buffer_r;
-    return out;
-  }
-};
-
-struct PacketTypeDriver {
-  static void drive(Vtb* tb) {
-    drive(tb, PacketType{});
-  }
-
-  static void drive(Vtb* tb, const PacketType& t) {
-    tb->packet_type_off_w = t.off;
-    tb->packet_type_w = t.type;
-  }
-};
-
-struct SymbolMatchDriver {
-  static void drive(Vtb* tb) {
-    std::vector<SymbolMatch> matches(4);
-    drive(tb, matches);
-  }
-
-  static void drive(Vtb* tb, const std::vector<SymbolMatch>& m) {
-    for (std::size_t i = 0; i < m.size(); i++) {
-      switch (i) {
-        case 0: {
-          tb->match0_vld_w = m[0].valid;
-          tb->match0_off_w = m[0].off;
-          tb->match0_match_w = m[0].match;
-          tb->match0_buffer_w = m[0].buffer;
-        } break;
-        case 1: {
-          tb->match1_vld_w = m[1].valid;
-          tb->match1_off_w = m[1].off;
-          tb->match1_match_w = m[1].match;
-          tb->match1_buffer_w = m[1].buffer;
-        } break;
-        case 2: {
-          tb->match2_vld_w = m[2].valid;
-          tb->match2_off_w = m[2].off;
-          tb->match2_match_w = m[2].match;
-          tb->match2_buffer_w = m[2].buffer;
-        } break;
-        case 3: {
-          tb->match3_vld_w = m[3].valid;
-          tb->match3_off_w = m[3].off;
-          tb->match3_match_w = m[3].match;
-          tb->match3_buffer_w = m[3].buffer;
-        } break;
-      }
-    }
-  }
-};
-
-TB::TB(const Options& opts) : opts_(opts) {
+TB::TB(const Options& opts) : opts_(opts), instances_(K) {
+#ifdef OPT_PROF_ENABLE
+  prof::Scope scope{prof::Section::Construct};
+#endif
 #ifdef OPT_VCD_ENABLE
   if (opts.vcd_enable) {
     Verilated::traceEverOn(true);
   }
 #endif
   tb_ = new Vtb("tb");
+  tb_->eval();
+  QueueMonitor::check(tb_);
+  for (Instance& i : instances_) {
+    i.model = new Model;
+    i.egress = new EgressModel(opts_.egress);
+    i.scoreboard = new Scoreboard(logging_enabled(opts_));
+    i.cpl_model = new CplModel;
+  }
 #ifdef OPT_LOGGING_ENABLE
-  std::cout << "[TB] Building testbench\n";
+  if (opts_.logging_enable) {
+    log::phase(0, log::Phase::Build);
+  }
 #endif
 #ifdef OPT_VCD_ENABLE
   if (opts.vcd_enable) {
     vcd_ = new VerilatedVcdC;
     tb_->trace(vcd_, 99);
     vcd_->open(opts.vcd_name.c_str());
-#ifdef OPT_LOGGING_ENABLE
-    std::cout << "[TB] Dumping to VCD: " << opts.vcd_name << "\n";
-#endif
   }
 #endif
 }
 
 TB::~TB() {
+  for (Instance& i : instances_) {
+    delete i.cpl_model;
+    delete i.scoreboard;
+    delete i.egress;
+    delete i.model;
+  }
   delete tb_;
 #ifdef OPT_VCD_ENABLE
   if (vcd_) {
@@ -171,73 +141,169 @@ TB::~TB() {
 }
 
 void TB::run(std::deque<TestCase>& tests) {
+  std::vector<std::deque<TestCase>> streams(1);
+  streams.front().swap(tests);
+  run(streams);
+  tests.swap(streams.front());
+}
+
+void TB::run(std::vector<std::deque<TestCase>>& tests) {
+  // One stream of tests per instance; surplus instances idle.
+  ASSERT_LE(tests.size(), K);
+#ifdef OPT_PROF_ENABLE
+  prof::RunScope run_scope{run_label()};
+#endif
+
   tb_->clk_net = false;
   tb_->rst_net = false;
   
   tb_->clk_host = false;
   tb_->rst_host = false;
 
-  // Drive various interfaces to idle.
-  InDriver::drive(tb_);
-  PacketTypeDriver::drive(tb_);
-  SymbolMatchDriver::drive(tb_);
-
   net_context_.state = NetState::PreReset;
   net_context_.reset_ticks = 10;
 
   host_context_.state = HostState::PreReset;
   host_context_.reset_ticks = 10;
 
+  for (std::size_t k = 0; k < K; k++) {
+    Instance& i{instances_[k]};
+    i.tests = (k < tests.size()) ? &tests[k] : nullptr;
+    i.actual_in.clear();
+    i.started = 0;
+    i.cfg.written = 0;
+    i.cfg.committed = 0;
+    i.cfg.busy = false;
+    i.stats = Stats{};
+    schedule(k);
+    *i.model = Model();
+    *i.scoreboard = Scoreboard(logging_enabled(opts_));
+    *i.egress = EgressModel(opts_.egress);
+    *i.cpl_model = CplModel();
+    i.cpl.cons = 0;
+    i.cpl.seq = 0;
+    i.cpl.servicing = false;
+    i.cpl.wait = 0;
+    i.cpl.eop_times.clear();
+
+    // Drive various interfaces to idle.
+    InDriver::drive(tb_, k);
+    RuleDriver::drive(tb_, k);
+    CplDriver::consume(tb_, k, i.cpl.cons);
+
+    // Egress and completion configuration is static throughout the
+    // run.
+    EgressDriver::drive(tb_, k, opts_.egress);
+    CplDriver::drive(tb_, k, opts_.cpl);
+  }
+
+  time_ = 0;
 #ifdef OPT_LOGGING_ENABLE
-  std::cout << "[TB] Starting simulation\n";
+  if (opts_.logging_enable) {
+    log::phase(time_, log::Phase::Start);
+    log::EventLog::local().context(
+        log::Record{time_, log::Event::Seed, 0, 0, 0, 0, Random::seed(), 0});
+  }
 #endif
-  
-  time_ = 0;
+
+  sim_context_.stopped = false;
   while (!sim_context_.stopped) {
     time_++;
 
-    if (time_ % 10 == 0) {
+    if (time_ % opts_.net_half_period == 0) {
       if (tb_->clk_net) {
         // Testbench drives on the negative edge of the clock edge
         // for readability in the waveform; no functional impact.
-        on_net_clk_negedge(tests);
+#ifdef OPT_PROF_ENABLE
+        prof::Scope scope{prof::Section::NetDrive};
+#endif
+        on_net_clk_negedge();
       }
       tb_->clk_net = !tb_->clk_net;
     }
-    if (time_ % 5 == 0) {
+    if (time_ % opts_.host_half_period == 0) {
       // Testbench samples RTL on negative edge of the host clock to
       // avoid synchronization issues with the RTL.
       if (tb_->clk_host) {
+#ifdef OPT_PROF_ENABLE
+        prof::Scope scope{prof::Section::HostSample};
+#endif
         on_host_clk_negedge();
       }
       tb_->clk_host = !tb_->clk_host;
     }
-    tb_->eval();
+    {
+#ifdef OPT_PROF_ENABLE
+      prof::Scope scope{prof::Section::Eval};
+#endif
+      tb_->eval();
+    }
 #ifdef OPT_VCD_ENABLE
     if (vcd_) {
+#  ifdef OPT_PROF_ENABLE
+      prof::Scope scope{prof::Section::Trace};
+#  endif
       vcd_->dump(time_);
     }
 #endif
   }
 
-  // All stimulus must have been emitted.
-  std::deque<In>& ins = sim_context_.actual_in;
-  EXPECT_TRUE(ins.empty());
+#ifdef OPT_PROF_ENABLE
+  prof::Scope complete_scope{prof::Section::Complete};
+#endif
+
+  for (std::size_t k = 0; k < K; k++) {
+    Instance& i{instances_[k]};
+
+    // All stimulus must have been emitted.
+    EXPECT_TRUE(i.actual_in.empty());
   
-  // At the end of time, expect that the RTL has been appropriately
-  // flushed.
-  std::deque<Out>& outs{sim_context_.expected_out};
-  EXPECT_TRUE(outs.empty());
+    // At the end of time, expect that the RTL has been appropriately
+    // flushed.
+    EXPECT_TRUE(i.scoreboard->drained());
+
+    // All tests must have run:
+    if (i.tests) { EXPECT_TRUE(i.tests->empty()); }
 
-  // All tests must have run:
-  EXPECT_TRUE(tests.empty());
+    i.stats.packets = i.model->stats().packets;
+    i.stats.matched = i.model->stats().matched;
+    i.stats.delivered = i.egress->stats().delivered;
+    i.stats.egress_overflows = EgressDriver::overflows(tb_, k);
+    i.stats.out_digest = i.scoreboard->stats().digest;
+    i.stats.cpl_overflows = CplDriver::overflows(tb_, k);
+
+    // Egress must never be lost in the clock-crossing.
+    EXPECT_EQ(i.stats.afifo_overflows, 0);
+    EXPECT_EQ(i.stats.vfifo_overflows, 0);
+
+    // Packets discarded by the egress buffer must be those predicted.
+    EXPECT_EQ(i.stats.egress_overflows, i.egress->stats().overflows);
+
+    // A descriptor must have been consumed for every packet delivered,
+    // and none lost.
+    EXPECT_TRUE(i.cpl_model->drained());
+    EXPECT_EQ(i.stats.cpl_overflows, 0);
+    
+    i.tests = nullptr;
+  }
 
 #ifdef OPT_LOGGING_ENABLE
-  std::cout << "[TB] Simulation complete!\n";
+  if (opts_.logging_enable) {
+    log::phase(time_, log::Phase::Complete);
+  }
 #endif
 }
 
-void TB::on_net_clk_negedge(std::deque<TestCase>& tests) {
+void TB::on_net_clk_negedge() {
+  for (std::size_t k = 0; k < K; k++) {
+    // Monitor clock-crossing queue occupancy.
+    Stats& stats{instances_[k].stats};
+    QueueMonitor::record(QueueMonitor::afifo(tb_, k), AFIFO_N,
+                         stats.afifo_high_water, stats.afifo_overflows);
+    QueueMonitor::record(QueueMonitor::vfifo(tb_, k), VFIFO_N,
+                         stats.vfifo_high_water, stats.vfifo_overflows);
+  }
+
   switch (net_context_.state) {
     case NetState::PreReset: {
       tb_->rst_net = true;
@@ -250,53 +316,190 @@ void TB::on_net_clk_negedge(std::deque<TestCase>& tests) {
       }
     } break;
     case NetState::Active: {
-      // Drive to idle.
-      InDriver::drive(tb_);
-      PacketTypeDriver::drive(tb_);
-      SymbolMatchDriver::drive(tb_);
-
-      std::deque<In>& ins = sim_context_.actual_in;
-      if (ins.empty()) {
-        // Start new test
-        if (tests.empty()) {
-          // Simulus exhausted; wind-down simulation awaiting state
-          // which is currently inflight to be emitted.
-          net_context_.state = NetState::PostActive;
-          net_context_.reset_ticks = 20;
-          return;
-        }
-
-        TestCase& test = tests.front();
-#ifdef OPT_LOGGING_ENABLE
-        if (opts_.logging_enable) {
-          std::cout << "[TB] Start test: " << test.to_string() << "\n";
-        }
-#endif
-        for (const In& in : test.in) {
-          ins.push_back(in);
-        }
-        for (const Out& out : test.out) {
-          std::deque<Out>& outs{sim_context_.expected_out};
-          outs.push_back(out);
-        }
-        PacketTypeDriver::drive(tb_, test.type);
-        SymbolMatchDriver::drive(tb_, test.match);
-        tests.pop_front();
+      bool active = false;
+      for (std::size_t k = 0; k < K; k++) {
+        active |= on_net_drive(k);
+      }
+      if (!active) {
+        // Simulus exhausted; wind-down simulation awaiting state
+        // which is currently inflight to be emitted.
+        net_context_.state = NetState::PostActive;
+        net_context_.reset_ticks = 20;
+        // Packets retained by the egress buffer drain at no less than
+        // one word per cycle.
+        net_context_.drain_ticks = CHAN_N * EGRESS_N;
       }
-      InDriver::drive(tb_, ins.front());
-      ins.pop_front();
     } break;
     case NetState::PostActive: {
-      // Wind down simulation
-      if (--net_context_.reset_ticks == 0) {
+      // Wind down simulation; thereafter, await the egress to drain.
+      if (net_context_.reset_ticks != 0) {
+        --net_context_.reset_ticks;
+      } else if (drained() || (--net_context_.drain_ticks == 0)) {
         sim_context_.stopped = true;
       }
     } break;
   }
 }
 
+bool TB::drained() const {
+  return std::all_of(instances_.begin(), instances_.end(),
+                     [](const Instance& i) {
+                       return i.scoreboard->drained() &&
+                              i.cpl_model->drained();
+                     });
+}
+
+void TB::schedule(std::size_t k) {
+  Instance& i{instances_[k]};
+  i.uses.clear();
+  i.writes.clear();
+  if (!i.tests) return;
+
+  // Flow resident in each entry, the number of tests up to and
+  // including its most recent user, and the number of writes up to
+  // and including that which loaded it.
+  std::array<std::size_t, RULE_N> flow;
+  std::array<std::size_t, RULE_N> used;
+  std::array<std::size_t, RULE_N> loaded;
+  flow.fill(TestCase::NO_FLOW);
+  used.fill(0);
+  loaded.fill(0);
+
+  for (std::size_t t = 0; t < i.tests->size(); t++) {
+    const TestCase& test{(*i.tests)[t]};
+    std::size_t e = RULE_N;
+    if (test.flow != TestCase::NO_FLOW) {
+      e = std::find(flow.begin(), flow.end(), test.flow) - flow.begin();
+    }
+    if (e == RULE_N) {
+      // Flow is not resident; evict the least recently used entry,
+      // once its last user has been issued.
+      e = std::min_element(used.begin(), used.end()) - used.begin();
+      i.writes.push_back(
+          Instance::RuleWrite{static_cast<vluint8_t>(e), t, used[e]});
+      flow[e] = test.flow;
+      loaded[e] = i.writes.size();
+    }
+    i.uses.push_back(
+        Instance::RuleUse{static_cast<vluint8_t>(e), loaded[e]});
+    used[e] = t + 1;
+  }
+}
+
+bool TB::on_net_drive(std::size_t k) {
+  Instance& i{instances_[k]};
+
+  // Drive to idle.
+  InDriver::drive(tb_, k);
+
+  if (!InDriver::ready(tb_, k)) {
+    // Ingress is stalled (see: m.sv, in_rdy_w); no beat is issued
+    // until ready.
+    return true;
+  }
+
+  std::deque<In>& ins = i.actual_in;
+  if (ins.empty()) {
+    // Start new test
+    if (!i.tests || i.tests->empty()) {
+      // Stimulus of the instance is exhausted.
+      return false;
+    }
+
+    const Instance::RuleUse& use{i.uses[i.started]};
+    if (i.cfg.committed < use.writes) {
+      // Rule set of the next test is not yet active; stall.
+      return true;
+    }
+
+    TestCase& test = i.tests->front();
+#ifdef OPT_LOGGING_ENABLE
+    if (opts_.logging_enable) {
+      log::Record& r = log::EventLog::local().push();
+      r = log::Record{time_, log::Event::TestStart,
+                      0, 0, 0, static_cast<std::uint32_t>(k), test.id,
+                      test.bytes};
+    }
+#endif
+    i.started++;
+    for (In in : test.in) {
+      in.rule = use.entry;
+      ins.push_back(in);
+    }
+    i.tests->pop_front();
+  }
+  InDriver::drive(tb_, k, ins.front());
+  Out predicted;
+  if (i.model->predict(ins.front(), predicted)) {
+    // Words are predicted at the host as delivered by the egress
+    // buffer.
+    delivered_.clear();
+    i.egress->predict(predicted, delivered_);
+    for (const Out& out : delivered_) {
+      i.scoreboard->predict(out);
+      i.cpl_model->predict(out);
+    }
+  }
+  if (ins.front().valid) {
+    if (i.stats.in_words++ == 0) { i.stats.in_first = time_; }
+    i.stats.in_last = time_;
+  }
+#ifdef OPT_LOGGING_ENABLE
+  if (opts_.logging_enable) {
+    const In& in{ins.front()};
+    log::beat(log::Event::BeatDriven, time_, k, in.valid, in.chan, in.sop,
+              in.eop, in.sop_off, in.length, in.data);
+  }
+#endif
+  ins.pop_front();
+  return true;
+}
+
+void TB::on_host_cfg(std::size_t k) {
+  Instance& i{instances_[k]};
+
+  RuleDriver::drive(tb_, k);
+
+  if (i.cfg.busy) {
+    // Await completion of the outstanding commit.
+    if (!RuleDriver::busy(tb_, k)) {
+      i.model->commit();
+      i.cfg.committed = i.cfg.target;
+      i.cfg.busy = false;
+    }
+    return;
+  }
+
+  // Tests which have been issued by the NET domain are no longer
+  // present in 'tests'.
+  const std::size_t started = i.started;
+  // A test may comprise many packets, each of which samples the rule
+  // set on SOP; the rule set is latched only once all words of the
+  // test have been issued.
+  const std::size_t issued = started - (i.actual_in.empty() ? 0 : 1);
+  const std::size_t next = i.cfg.written;
+  if ((next < i.writes.size()) && (i.writes[next].after <= issued)) {
+    // Rule set entry is no longer required by the test which last
+    // used it (the test has been issued and the rule set has been
+    // latched); write the rule set of the next test to use the entry
+    // (which, being yet to start, remains in 'tests'). Writes are
+    // applied to the inactive copy of the entry, and do not affect
+    // the current rule set until committed.
+    const Instance::RuleWrite& w{i.writes[next]};
+    const m::Rule rule = to_rule((*i.tests)[w.test - started]);
+    RuleDriver::drive(tb_, k, w.entry, rule);
+    i.model->write(w.entry, rule);
+    i.cfg.written++;
+    i.stats.rule_writes++;
+  } else if (i.cfg.written != i.cfg.committed) {
+    // Commit all written rule sets.
+    RuleDriver::commit(tb_, k);
+    i.cfg.busy = true;
+    i.cfg.target = i.cfg.written;
+  }
+}
+
 void TB::on_host_clk_negedge() {
-  bool ret = true;
   switch (host_context_.state) {
     case HostState::PreReset: {
       tb_->rst_host = true;
@@ -309,33 +512,96 @@ void TB::on_host_clk_negedge() {
       }
     } break;
     case HostState::Active: {
-      const Out actual = OutMonitor::get(tb_);
-      if (actual.valid) {
-        std::deque<Out>& outs{sim_context_.expected_out};
-
-        // Error out immediately if receiving unexpected output.
-        ASSERT_FALSE(outs.empty());
-        
-        const Out& expected{outs.front()};
-
-        // Validate actual vs. expected.
-        EXPECT_EQ(expected.sop, actual.sop);
-        EXPECT_EQ(expected.eop, actual.eop);
-        EXPECT_EQ(expected.data, actual.data);
-        if (expected.eop) {
-          // Length is only considered wehn EOP is valid.
-          EXPECT_EQ(expected.length, actual.length);
-          EXPECT_EQ(expected.buffer, actual.buffer);
-        }
-        outs.pop_front();
+      for (std::size_t k = 0; k < K; k++) {
+        on_host_cfg(k);
+        on_host_observe(k);
+        on_host_cpl(k);
       }
     } break;
   }
 }
 
-} // namespace tb
+void TB::on_host_observe(std::size_t k) {
+  Instance& i{instances_[k]};
 
-int main(int argc, char** argv) {
-  testing::InitGoogleTest(&argc, argv);
-  return RUN_ALL_TESTS();
+  const Out actual = OutMonitor::get(tb_, k);
+  if (actual.valid) {
+#ifdef OPT_LOGGING_ENABLE
+    if (opts_.logging_enable) {
+      log::beat(log::Event::BeatObserved, time_, k, actual.valid, actual.chan,
+                actual.sop, actual.eop, actual.sop_off, actual.length,
+                actual.data, from_status(actual.status), actual.buffer);
+    }
+#endif
+    // Validate actual vs. expected.
+    i.scoreboard->observe(actual, time_);
+
+    if (i.stats.out_words++ == 0) { i.stats.out_first = time_; }
+    i.stats.out_last = time_;
+
+    // A descriptor is written for each packet delivered.
+    if (actual.eop) { i.cpl.eop_times.push_back(time_); }
+  }
 }
+
+void TB::on_host_cpl(std::size_t k) {
+  Instance& i{instances_[k]};
+
+  if (CplDriver::irq(tb_, k)) {
+    i.stats.cpl_notifications++;
+    if (!i.cpl.servicing) {
+      i.cpl.servicing = true;
+      i.cpl.wait = opts_.cpl_service_latency;
+    }
+  }
+
+  // Once stimulus is exhausted, the ring is polled such that
+  // descriptors yet to be notified are consumed.
+  if (net_context_.state == NetState::PostActive) { i.cpl.servicing = true; }
+
+  if (!i.cpl.servicing) return;
+
+  if (i.cpl.wait != 0) {
+    i.cpl.wait--;
+    return;
+  }
+
+  if (CplDriver::prod(tb_, k) == i.cpl.cons) {
+    // Ring is empty; await the next notification.
+    i.cpl.servicing = false;
+    return;
+  }
+
+  // The descriptor at the consumer pointer is presented on the read
+  // port.
+  const Descriptor d = CplDriver::read(tb_, k);
+  EXPECT_EQ(d.seq, i.cpl.seq) << "Descriptor lost";
+  i.cpl.seq = d.seq + 1;
+
+  Descriptor e;
+  if (!i.cpl_model->pop(d.chan, e)) {
+    ADD_FAILURE() << "Unexpected descriptor; channel:"
+                  << static_cast<int>(d.chan);
+  } else {
+    EXPECT_EQ(e.bytes, d.bytes) << "seq:" << d.seq;
+    EXPECT_EQ(e.status.type_hit, d.status.type_hit) << "seq:" << d.seq;
+    EXPECT_EQ(e.status.hit, d.status.hit) << "seq:" << d.seq;
+    EXPECT_EQ(e.status.slot, d.status.slot) << "seq:" << d.seq;
+    EXPECT_EQ(e.buffer, d.buffer) << "seq:" << d.seq;
+  }
+
+  if (!i.cpl.eop_times.empty()) {
+    const std::size_t latency =
+        (time_ - i.cpl.eop_times.front()) / (2 * opts_.host_half_period);
+    i.cpl.eop_times.pop_front();
+    i.stats.cpl_latency_sum += latency;
+    i.stats.cpl_latency_max = std::max(i.stats.cpl_latency_max, latency);
+  }
+  i.stats.cpl_descriptors++;
+
+  // Return the descriptor to the ring.
+  i.cpl.cons = (i.cpl.cons + 1) % (2 * CPL_N);
+  CplDriver::consume(tb_, k, i.cpl.cons);
+}
+
+} // namespace tb
@@ -30,56 +30,124 @@
 
 `include "m_pkg.vh"
 
-module tb (
+// Testbench top; K independent instances of 'm' simulated in lockstep
+// on common clocks and resets. Each instance has its own ingress,
+// egress and rule table configuration interfaces, flattened onto
+// the ports below such that instance 'k' occupies element 'k' of
+// each port.
+
+module tb #(
+    parameter int K = 1
+    // Match pipeline depth of instance 0; instance 'k' has depth
+    // (MATCH_DEPTH + k) modulo (MATCH_DEPTH_MAX + 1), such that the
+    // instances sweep the permissible depths.
+  , parameter int MATCH_DEPTH = m_pkg::MATCH_DEPTH_MAX
+) (
 
   // ======================================================================== //
   // Ingress
-    input                                         in_vld_w
-  , input logic                                   in_sop_w
-  , input logic                                   in_eop_w
-  , input m_pkg::len_t                            in_length_w
-  , input m_pkg::data_t                           in_data_w
+    input [K-1:0]                                 in_vld_w
+  , input m_pkg::chan_t [K-1:0]                   in_chan_w
+  , input m_pkg::rule_idx_t [K-1:0]               in_rule_w
+  , input [K-1:0]                                 in_sop_w
+  , input [K-1:0]                                 in_eop_w
+  , input m_pkg::len_t [K-1:0]                    in_sop_off_w
+  , input m_pkg::len_t [K-1:0]                    in_length_w
+  , input m_pkg::data_t [K-1:0]                   in_data_w
+  , output logic [K-1:0]                          in_rdy_w
 
   // ======================================================================== //
   // Egress
-  , output logic                                  out_vld_r
-  , output logic                                  out_sop_r
-  , output logic                                  out_eop_r
-  , output m_pkg::len_t                           out_length_r
-  , output m_pkg::data_t                          out_data_r
-  , output m_pkg::buffer_t                        out_buffer_r
+  , output logic [K-1:0]                          out_vld_r
+  , output m_pkg::chan_t [K-1:0]                  out_chan_r
+  , output logic [K-1:0]                          out_sop_r
+  , output logic [K-1:0]                          out_eop_r
+  , output m_pkg::len_t [K-1:0]                   out_sop_off_r
+  , output m_pkg::len_t [K-1:0]                   out_length_r
+  , output m_pkg::data_t [K-1:0]                  out_data_r
+  , output m_pkg::status_t [K-1:0]                out_status_r
+  , output m_pkg::buffer_t [K-1:0]                out_buffer_r
+
+  // Egress configuration (static) and overflow accounting
+  , input m_pkg::egress_mode_t [K-1:0]            cfg_egress_mode_w
+  , input m_pkg::packet_word_off_t [K-1:0]        cfg_egress_hdr_w
+  , input m_pkg::egress_depth_t [K-1:0]           cfg_egress_depth_w
+  , output m_pkg::egress_count_t [K-1:0]          out_overflows_r
 
   // ======================================================================== //
-  // Packet type interface
-  , input m_pkg::packet_off_t                     packet_type_off_w
-  , input m_pkg::packet_type_t                    packet_type_w
+  // Completion ring; configuration (static), consumer pointer and
+  // descriptor read port.
+  , input [K-1:0][7:0]                            cfg_cpl_count_w
+  , input [K-1:0][15:0]                           cfg_cpl_timeout_w
+  , input m_pkg::cpl_ptr_t [K-1:0]                cpl_cons_w
+  , input m_pkg::cpl_idx_t [K-1:0]                cpl_rd_idx_w
+  , output m_pkg::cpl_seq_t [K-1:0]               cpl_rd_seq_w
+  , output m_pkg::chan_t [K-1:0]                  cpl_rd_chan_w
+  , output m_pkg::cpl_bytes_t [K-1:0]             cpl_rd_bytes_w
+  , output m_pkg::status_t [K-1:0]                cpl_rd_status_w
+  , output m_pkg::buffer_t [K-1:0]                cpl_rd_buffer_w
+  , output m_pkg::cpl_ptr_t [K-1:0]               cpl_prod_r
+  , output logic [K-1:0]                          cpl_irq_r
+  , output m_pkg::egress_count_t [K-1:0]          cpl_overflows_r
 
   // ======================================================================== //
-  // Match interface
+  // Rule table configuration interface
+  , input [K-1:0]                                 cfg_vld_w
+  , input m_pkg::rule_idx_t [K-1:0]               cfg_idx_w
+  , input [K-1:0]                                 cfg_commit_w
+  , output logic [K-1:0]                          cfg_busy_r
+
+  // Packet type
+  , input m_pkg::packet_off_t [K-1:0]             cfg_type_off_w
+  , input m_pkg::packet_type_t [K-1:0]            cfg_type_w
+
+  // Symbol search mode
+  , input [K-1:0]                                 cfg_sym_anywhere_w
 
   // Interface 0
-  , input                                         match0_vld_w
-  , input m_pkg::packet_word_off_t                match0_off_w
-  , input m_pkg::data_t                           match0_match_w
-  , input m_pkg::buffer_t                         match0_buffer_w
+  , input [K-1:0]                                 cfg_match0_vld_w
+  , input m_pkg::packet_word_off_t [K-1:0]        cfg_match0_off_w
+  , input m_pkg::data_t [K-1:0]                   cfg_match0_match_w
+  , input m_pkg::buffer_t [K-1:0]                 cfg_match0_buffer_w
 
   // Interface 1
-  , input                                         match1_vld_w
-  , input m_pkg::packet_word_off_t                match1_off_w
-  , input m_pkg::data_t                           match1_match_w
-  , input m_pkg::buffer_t                         match1_buffer_w
+  , input [K-1:0]                                 cfg_match1_vld_w
+  , input m_pkg::packet_word_off_t [K-1:0]        cfg_match1_off_w
+  , input m_pkg::data_t [K-1:0]                   cfg_match1_match_w
+  , input m_pkg::buffer_t [K-1:0]                 cfg_match1_buffer_w
 
   // Interface 2
-  , input                                         match2_vld_w
-  , input m_pkg::packet_word_off_t                match2_off_w
-  , input m_pkg::data_t                           match2_match_w
-  , input m_pkg::buffer_t                         match2_buffer_w
+  , input [K-1:0]                                 cfg_match2_vld_w
+  , input m_pkg::packet_word_off_t [K-1:0]        cfg_match2_off_w
+  , input m_pkg::data_t [K-1:0]                   cfg_match2_match_w
+  , input m_pkg::buffer_t [K-1:0]                 cfg_match2_buffer_w
 
   // Interface 3
-  , input                                         match3_vld_w
-  , input m_pkg::packet_word_off_t                match3_off_w
-  , input m_pkg::data_t                           match3_match_w
-  , input m_pkg::buffer_t                         match3_buffer_w
+  , input [K-1:0]                                 cfg_match3_vld_w
+  , input m_pkg::packet_word_off_t [K-1:0]        cfg_match3_off_w
+  , input m_pkg::data_t [K-1:0]                   cfg_match3_match_w
+  , input m_pkg::buffer_t [K-1:0]                 cfg_match3_buffer_w
+
+  // ======================================================================== //
+  // Clock-crossing queue state (m.sv: u_async_queue, u_verdict_queue),
+  // such that queue occupancy may be monitored during simulation.
+  // Pointers carry an additional wrap bit.
+  , output logic [K-1:0]                          afifo_push_w
+  , output logic [K-1:0][4:0]                     afifo_wptr_r
+  , output logic [K-1:0][4:0]                     afifo_rptr_r
+  //
+  , output logic [K-1:0]                          vfifo_push_w
+  , output logic [K-1:0][3:0]                     vfifo_wptr_r
+  , output logic [K-1:0][3:0]                     vfifo_rptr_r
+  //
+  // Depth and entry width (bits) of the clock-crossing queues, and
+  // the width of the entire egress word (m_pkg), such that the
+  // constants of the testbench may be checked against the RTL.
+  , output logic [31:0]                           afifo_n_w
+  , output logic [31:0]                           afifo_bits_w
+  , output logic [31:0]                           vfifo_n_w
+  , output logic [31:0]                           vfifo_bits_w
+  , output logic [31:0]                           out_bits_w
 
   // ======================================================================== //
   // Clk/Reset
@@ -90,82 +158,136 @@ module tb (
   , input                                         rst_host
 );
 
-  //
-  m_pkg::in_t                      in_w;
-  m_pkg::out_t                     out_r;
+  for (genvar k = 0; k < K; k++) begin : g_inst
 
-  m_pkg::sym_match_t [3:0]         symbol_match_w;
+    //
+    m_pkg::in_t                      in_w;
+    m_pkg::out_t                     out_r;
 
-  // ------------------------------------------------------------------------ //
-  //
-  always_comb begin : in_PROC
+    m_pkg::rule_t                    cfg_rule_w;
+    m_pkg::egress_cfg_t              cfg_egress_w;
+    m_pkg::cpl_cfg_t                 cfg_cpl_w;
+    m_pkg::cpl_desc_t                cpl_rd_desc_w;
 
-    in_w                       = '0;
-    in_w.sop                   = in_sop_w;
-    in_w.eop                   = in_eop_w;
-    in_w.length                = in_length_w;
-    in_w.data                  = in_data_w;
+    // ---------------------------------------------------------------------- //
+    //
+    always_comb begin : in_PROC
 
-    symbol_match_w             = '0;
+      in_w                       = '0;
+      in_w.chan                  = in_chan_w [k];
+      in_w.rule                  = in_rule_w [k];
+      in_w.sop                   = in_sop_w [k];
+      in_w.eop                   = in_eop_w [k];
+      in_w.sop_off               = in_sop_off_w [k];
+      in_w.length                = in_length_w [k];
+      in_w.data                  = in_data_w [k];
 
-    //
-    symbol_match_w [0].valid   = match0_vld_w;
-    symbol_match_w [0].off     = match0_off_w;
-    symbol_match_w [0].match   = match0_match_w;
-    symbol_match_w [0].buffer  = match0_buffer_w;
+      cfg_egress_w               = '0;
+      cfg_egress_w.mode          = cfg_egress_mode_w [k];
+      cfg_egress_w.hdr           = cfg_egress_hdr_w [k];
+      cfg_egress_w.depth         = cfg_egress_depth_w [k];
 
-    //
-    symbol_match_w [1].valid   = match1_vld_w;
-    symbol_match_w [1].off     = match1_off_w;
-    symbol_match_w [1].match   = match1_match_w;
-    symbol_match_w [1].buffer  = match1_buffer_w;
+      cfg_cpl_w                  = '0;
+      cfg_cpl_w.count            = cfg_cpl_count_w [k];
+      cfg_cpl_w.timeout          = cfg_cpl_timeout_w [k];
 
-    //
-    symbol_match_w [2].valid   = match2_vld_w;
-    symbol_match_w [2].off     = match2_off_w;
-    symbol_match_w [2].match   = match2_match_w;
-    symbol_match_w [2].buffer  = match2_buffer_w;
+      cfg_rule_w                 = '0;
+      cfg_rule_w.type_off        = cfg_type_off_w [k];
+      cfg_rule_w.type            = cfg_type_w [k];
+      cfg_rule_w.sym_anywhere    = cfg_sym_anywhere_w [k];
 
+      //
+      cfg_rule_w.symbol [0].valid   = cfg_match0_vld_w [k];
+      cfg_rule_w.symbol [0].off     = cfg_match0_off_w [k];
+      cfg_rule_w.symbol [0].match   = cfg_match0_match_w [k];
+      cfg_rule_w.symbol [0].buffer  = cfg_match0_buffer_w [k];
+
+      //
+      cfg_rule_w.symbol [1].valid   = cfg_match1_vld_w [k];
+      cfg_rule_w.symbol [1].off     = cfg_match1_off_w [k];
+      cfg_rule_w.symbol [1].match   = cfg_match1_match_w [k];
+      cfg_rule_w.symbol [1].buffer  = cfg_match1_buffer_w [k];
+
+      //
+      cfg_rule_w.symbol [2].valid   = cfg_match2_vld_w [k];
+      cfg_rule_w.symbol [2].off     = cfg_match2_off_w [k];
+      cfg_rule_w.symbol [2].match   = cfg_match2_match_w [k];
+      cfg_rule_w.symbol [2].buffer  = cfg_match2_buffer_w [k];
+
+      //
+      cfg_rule_w.symbol [3].valid   = cfg_match3_vld_w [k];
+      cfg_rule_w.symbol [3].off     = cfg_match3_off_w [k];
+      cfg_rule_w.symbol [3].match   = cfg_match3_match_w [k];
+      cfg_rule_w.symbol [3].buffer  = cfg_match3_buffer_w [k];
+
+    end // block: in_PROC
+
+    // ---------------------------------------------------------------------- //
     //
-    symbol_match_w [3].valid   = match3_vld_w;
-    symbol_match_w [3].off     = match3_off_w;
-    symbol_match_w [3].match   = match3_match_w;
-    symbol_match_w [3].buffer  = match3_buffer_w;
-        
-  end // block: in_PROC
-
-  // ------------------------------------------------------------------------ //
-  //
-  m u_m (
-    //
-      .in_vld_w               (in_vld_w                )
-    , .in_w                   (in_w                    )
-    //
-    , .out_vld_r              (out_vld_r               )
-    , .out_r                  (out_r                   )
-    //
-    , .packet_type_off_w      (packet_type_off_w       )
-    , .packet_type_w          (packet_type_w           )
-    //
-    , .symbol_match_w         (symbol_match_w          )
-    //
-    , .clk_net                (clk_net                 )
-    , .rst_net                (rst_net                 )
+    m #(.MATCH_DEPTH((MATCH_DEPTH + k) % (m_pkg::MATCH_DEPTH_MAX + 1))) u_m (
+      //
+        .in_vld_w               (in_vld_w [k]            )
+      , .in_w                   (in_w                    )
+      , .in_rdy_w               (in_rdy_w [k]            )
+      //
+      , .out_vld_r              (out_vld_r [k]           )
+      , .out_r                  (out_r                   )
+      //
+      , .cfg_egress_w           (cfg_egress_w            )
+      , .out_overflows_r        (out_overflows_r [k]     )
+      //
+      , .cfg_cpl_w              (cfg_cpl_w               )
+      , .cpl_cons_w             (cpl_cons_w [k]          )
+      , .cpl_rd_idx_w           (cpl_rd_idx_w [k]        )
+      , .cpl_rd_desc_w          (cpl_rd_desc_w           )
+      , .cpl_prod_r             (cpl_prod_r [k]          )
+      , .cpl_irq_r              (cpl_irq_r [k]           )
+      , .cpl_overflows_r        (cpl_overflows_r [k]     )
+      //
+      , .cfg_vld_w              (cfg_vld_w [k]           )
+      , .cfg_idx_w              (cfg_idx_w [k]           )
+      , .cfg_rule_w             (cfg_rule_w              )
+      , .cfg_commit_w           (cfg_commit_w [k]        )
+      , .cfg_busy_r             (cfg_busy_r [k]          )
+      //
+      , .clk_net                (clk_net                 )
+      , .rst_net                (rst_net                 )
+      //
+      , .clk_host               (clk_host                )
+      , .rst_host               (rst_host)
+    );
+
+    // ---------------------------------------------------------------------- //
     //
-    , .clk_host               (clk_host                )
-    , .rst_host               (rst_host)
-  );
+    assign out_chan_r [k]    = out_r.chan;
+    assign out_sop_r [k]     = out_r.sop;
+    assign out_eop_r [k]     = out_r.eop;
+    assign out_sop_off_r [k] = out_r.sop_off;
+    assign out_length_r [k]  = out_r.length;
+    assign out_data_r [k]    = out_r.data;
+    assign out_status_r [k]  = out_r.status;
+    assign out_buffer_r [k]  = out_r.buffer;
 
-  // ------------------------------------------------------------------------ //
-  //
-  always_comb begin : out_PROC
+    assign cpl_rd_seq_w [k]    = cpl_rd_desc_w.seq;
+    assign cpl_rd_chan_w [k]   = cpl_rd_desc_w.chan;
+    assign cpl_rd_bytes_w [k]  = cpl_rd_desc_w.bytes;
+    assign cpl_rd_status_w [k] = cpl_rd_desc_w.status;
+    assign cpl_rd_buffer_w [k] = cpl_rd_desc_w.buffer;
+
+    assign afifo_push_w [k]  = u_m.u_async_queue.push;
+    assign afifo_wptr_r [k]  = u_m.u_async_queue.wptr_r;
+    assign afifo_rptr_r [k]  = u_m.u_async_queue.rptr_r;
+
+    assign vfifo_push_w [k]  = u_m.u_verdict_queue.push;
+    assign vfifo_wptr_r [k]  = u_m.u_verdict_queue.wptr_r;
+    assign vfifo_rptr_r [k]  = u_m.u_verdict_queue.rptr_r;
+
+  end // block: g_inst
 
-    out_sop_r     = out_r.sop;
-    out_eop_r     = out_r.eop;
-    out_length_r  = out_r.length;
-    out_data_r    = out_r.data;
-    out_buffer_r  = out_r.buffer;
+  assign afifo_n_w    = m_pkg::AFIFO_N;
+  assign afifo_bits_w = $bits(m_pkg::afifo_data_t);
+  assign vfifo_n_w    = m_pkg::VFIFO_N;
+  assign vfifo_bits_w = $bits(m_pkg::vfifo_data_t);
+  assign out_bits_w   = $bits(m_pkg::out_t);
 
-  end // block: out_PROC
-  
 endmodule // tb
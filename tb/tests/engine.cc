@@ -0,0 +1,267 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "engine.h"
+#include "queue.h"
+#include "matcher.h"
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Packet and rule set with the verdict expected of the software
+// matcher.
+struct Item {
+  std::vector<std::uint8_t> data;
+  m::Rule rule;
+  std::uint8_t expected = 0;
+};
+
+std::vector<Item> generate(std::size_t n) {
+  const m::Matcher matcher(m::Isa::Scalar);
+
+  std::vector<Item> items(n);
+  for (Item& it : items) {
+    const std::size_t bytes = tb::Random::uniform<std::size_t>(256, 1);
+    for (std::size_t i = 0; i < bytes; i++) {
+      it.data.push_back(tb::Random::uniform<std::uint16_t>(0xFF));
+    }
+    const std::size_t words = (bytes + 7) / 8;
+
+    // Packet type at some 4B within a word; corrupted on a miss.
+    const std::size_t word = tb::Random::uniform<std::size_t>(words - 1);
+    const std::size_t off = tb::Random::uniform<std::size_t>(4);
+    it.rule.type_off = (word * 8) + off;
+    for (std::size_t i = 0; i < 4; i++) {
+      const std::size_t b = (word * 8) + off + i;
+      const std::uint32_t v = (b < bytes) ? it.data[b] : 0;
+      it.rule.type |= (v << (i * 8));
+    }
+    if (tb::Random::boolean()) { it.rule.type = ~it.rule.type; }
+
+    // Symbol taken from some full word of the packet.
+    const std::size_t full = bytes / 8;
+    if (full != 0) {
+      const std::size_t i = tb::Random::uniform<std::size_t>(full - 1);
+      m::Symbol& s{it.rule.symbol[tb::Random::uniform<std::size_t>(3)]};
+      s.valid = true;
+      s.off = i;
+      std::memcpy(&s.match, it.data.data() + (i * 8), 8);
+      s.buffer = tb::Random::uniform<std::uint8_t>();
+    }
+
+    it.expected = matcher.match(it.rule, m::Packet{it.data.data(), bytes, 0});
+  }
+  return items;
+}
+
+void submit(tb::Engine& e, const std::vector<Item>& items, std::size_t tag) {
+  const Item& it{items[tag]};
+  const m::Packet pkt{it.data.data(), it.data.size(), 0};
+  while (!e.submit(tag, it.rule, pkt)) {
+    // Submission queue is full; await the simulation.
+    std::this_thread::yield();
+  }
+}
+
+} // namespace
+
+TEST(engine, queue) {
+  // Producers and consumers exchange distinct values through a queue
+  // of a capacity far below the volume transferred.
+  tb::MpmcQueue<std::size_t> q(16);
+  EXPECT_EQ(q.capacity(), 16);
+
+  const std::size_t threads_n = 4;
+  const std::size_t n = 100000;
+
+  std::atomic<std::size_t> sum{0};
+  std::atomic<std::size_t> popped{0};
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < threads_n; t++) {
+    threads.emplace_back([&, t] {
+      for (std::size_t i = t; i < n; i += threads_n) {
+        std::size_t v = i;
+        while (!q.push(v)) { std::this_thread::yield(); }
+      }
+    });
+    threads.emplace_back([&] {
+      std::size_t v;
+      while (popped < n) {
+        if (q.pop(v)) {
+          sum += v;
+          popped++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (std::thread& t : threads) { t.join(); }
+
+  std::size_t v;
+  EXPECT_FALSE(q.pop(v));
+  EXPECT_EQ(popped, n);
+  EXPECT_EQ(sum, (n * (n - 1)) / 2);
+}
+
+TEST(engine, callback) {
+  // Packets are submitted from several threads; verdicts (delivered
+  // to a callback) must agree with the software matcher.
+  tb::Random::init(1);
+
+  const std::size_t n = 2000;
+  const std::size_t threads_n = 4;
+  const std::vector<Item> items = generate(n);
+
+  std::vector<tb::Engine::Completion> done(n);
+  std::vector<std::size_t> count(n);
+  {
+    tb::Engine e(tb::Engine::Options{}, [&](const tb::Engine::Completion& c) {
+      done[c.tag] = c;
+      count[c.tag]++;
+    });
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threads_n; t++) {
+      threads.emplace_back([&, t] {
+        for (std::size_t i = t; i < n; i += threads_n) {
+          submit(e, items, i);
+        }
+      });
+    }
+    for (std::thread& t : threads) { t.join(); }
+    e.flush();
+
+    const tb::Engine::Stats s = e.stats();
+    EXPECT_EQ(s.submitted, n);
+    EXPECT_EQ(s.completed, n);
+    EXPECT_EQ(s.unexpected, 0);
+
+    std::cout << "[Engine] packets:" << n << " time:" << s.time << "\n";
+  }
+
+  std::size_t matched = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    EXPECT_EQ(count[i], 1) << "tag:" << i;
+    EXPECT_EQ(done[i].verdict, items[i].expected) << "tag:" << i;
+    EXPECT_LT(done[i].instance, tb::K);
+    EXPECT_GT(done[i].latency, 0);
+    if (items[i].expected != 0) { matched++; }
+  }
+  // Stimulus must exercise both outcomes.
+  EXPECT_NE(matched, 0);
+  EXPECT_NE(matched, n);
+}
+
+TEST(engine, poll) {
+  // Completions are retrieved by polling, interleaved with submission
+  // from the same thread through queues of limited capacity; the
+  // engine idles (and resumes) between bursts.
+  tb::Random::init(2);
+
+  const std::size_t n = 500;
+  const std::vector<Item> items = generate(n);
+
+  tb::Engine::Options opts;
+  opts.submit_n = 8;
+  opts.complete_n = 8;
+  tb::Engine e(opts);
+
+  std::vector<std::size_t> count(n);
+  tb::Engine::Completion c;
+  std::size_t completed = 0;
+  auto drain = [&]() {
+    while (e.poll(c)) {
+      count[c.tag]++;
+      EXPECT_EQ(c.verdict, items[c.tag].expected) << "tag:" << c.tag;
+      completed++;
+    }
+  };
+
+  for (std::size_t i = 0; i < n; i++) {
+    const Item& it{items[i]};
+    const m::Packet pkt{it.data.data(), it.data.size(), 0};
+    while (!e.submit(i, it.rule, pkt)) {
+      drain();
+      std::this_thread::yield();
+    }
+    if ((i % 100) == 99) {
+      // Await the burst in its entirety.
+      while (completed <= i) {
+        drain();
+        std::this_thread::yield();
+      }
+    }
+  }
+  while (completed < n) {
+    drain();
+    std::this_thread::yield();
+  }
+
+  for (std::size_t i = 0; i < n; i++) {
+    EXPECT_EQ(count[i], 1) << "tag:" << i;
+  }
+  EXPECT_FALSE(e.poll(c));
+  EXPECT_EQ(e.stats().unexpected, 0);
+}
+
+TEST(engine, reject) {
+  // Packets of no bytes, or beyond 2KB, are refused.
+  tb::Engine e;
+
+  const std::vector<std::uint8_t> data(2049);
+  const m::Rule rule;
+  EXPECT_FALSE(e.submit(0, rule, m::Packet{data.data(), 0, 0}));
+  EXPECT_FALSE(e.submit(1, rule, m::Packet{data.data(), 2049, 0}));
+  EXPECT_TRUE(e.submit(2, rule, m::Packet{data.data(), 2048, 0}));
+  e.flush();
+
+  const tb::Engine::Stats s = e.stats();
+  EXPECT_EQ(s.submitted, 1);
+  EXPECT_EQ(s.completed, 1);
+}
+
+TEST(engine, abandon) {
+  // The engine is destroyed with more packets outstanding than the
+  // completion queue can hold, none of which are polled; destruction
+  // must nonetheless complete.
+  tb::Random::init(3);
+
+  const std::size_t n = 64;
+  const std::vector<Item> items = generate(n);
+
+  tb::Engine::Options opts;
+  opts.complete_n = 4;
+  tb::Engine e(opts);
+  for (std::size_t i = 0; i < n; i++) { submit(e, items, i); }
+}
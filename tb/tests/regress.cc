@@ -28,10 +28,25 @@
 #include "gtest/gtest.h"
 #include "tb.h"
 #include "utility.h"
+#include "bloom.h"
+#include "traffic.h"
+#ifdef OPT_LOGGING_ENABLE
+#  include "log.h"
+#endif
+#ifdef OPT_PROF_ENABLE
+#  include "prof.h"
+#endif
+#include <algorithm>
+#include <array>
 #include <deque>
 #include <string>
 #include <random>
 #include <iostream>
+#include <cstring>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <chrono>
 
 template<typename T>
 class UniqueRandomIntegral {
@@ -64,6 +79,25 @@ class UniqueRandomIntegral {
   T hi_, lo_;
 };
 
+// Statistics of the symbol Bloom-filter prefilter (reference model).
+struct BloomStats {
+  // Matchable words presented to the filter.
+  std::size_t words = 0;
+
+  // Words hitting in the filter (requiring exact confirmation).
+  std::size_t hits = 0;
+
+  // Filter hits which failed exact confirmation.
+  std::size_t false_positives = 0;
+
+  BloomStats& operator+=(const BloomStats& s) {
+    words += s.words;
+    hits += s.hits;
+    false_positives += s.false_positives;
+    return *this;
+  }
+};
+
 class TestcaseBuilder {
  public:
   TestcaseBuilder() = default;
@@ -71,6 +105,9 @@ class TestcaseBuilder {
   // Number of packets to generate.
   std::size_t n = 1024;
 
+  // Minimum number of bytes within a packet
+  std::size_t min_len = 1;
+
   // Maximum number of bytes within a packet
   std::size_t max_len = 1500;
 
@@ -84,96 +121,308 @@ class TestcaseBuilder {
   // Probability of a match not taking place.
   double fail_match_probability = 0.1;
 
+  // Probability of symbols matched irrespective of word offset.
+  double symbol_anywhere_probability = 0.0;
+
+  // Probability of a packet starting in the final word of the prior
+  // packet (of the same channel).
+  double pack_probability = 0.0;
+
+  // Number of channels over which packets are interleaved, word by
+  // word [1, CHAN_N].
+  std::size_t chan_n = 1;
+
+  // Number of flows over which packets are drawn (uniformly), where
+  // non-zero; the packets of a flow share the operands of the flow,
+  // and match (where planted) with probability 1 -
+  // fail_match_probability. Otherwise, the operands of each packet
+  // are derived from the packet itself.
+  std::size_t flow_n = 0;
+
+  // Traffic profile (see: sw/traffic.h); where set, packet lengths,
+  // bubbles, flows and the match-hit ratio are drawn from the profile
+  // in place of the parameters above.
+  std::string profile;
+
   // Enable build logging
   bool logging_enable = false;
 
+  // Bloom-filter statistics of generated testcases.
+  BloomStats bloom_stats;
+
+  // Distinct flows of the generated testcases.
+  std::size_t flows() const { return flows_.size(); }
+
   void build(std::deque<tb::TestCase>& tc) {
+    if (!profile.empty()) {
+      profile_ = m::traffic::make_profile(profile);
+      if (!profile_) {
+        ADD_FAILURE() << "Unknown traffic profile: " << profile;
+        return;
+      }
+    }
+
+    // Most recent packet of each channel.
+    std::array<std::size_t, tb::CHAN_N> last;
+    last.fill(n);
+
     for (std::size_t i = 0; i < n; i++) {
       tb::TestCase t;
       t.id = i;
-      generate_testcase(t);
+      t.chan = (chan_n > 1) ? tb::Random::uniform<std::size_t>(chan_n - 1) : 0;
+
+      // Byte offset of SOP within the initial word of the packet;
+      // non-zero only where the packet is packed into the final word
+      // of the prior packet of the channel.
+      std::size_t sop_off = 0;
+      const std::size_t prior_i = last[t.chan];
+      if ((prior_i != n) && tb::Random::boolean(pack_probability)) {
+        const tb::In& prior = tc[prior_i].in.back();
+        // A word may start at most one packet and end at most one
+        // packet, therefore the prior packet must not start in its
+        // final word, and must leave at least one byte spare.
+        if (!prior.sop && (prior.length < 7)) {
+          sop_off = tb::Random::uniform<std::size_t>(7, prior.length + 1);
+        }
+        // The packed packet must extend beyond the shared word.
+        if ((sop_off != 0) && !profile_ && (max_len < (9 - sop_off))) {
+          sop_off = 0;
+        }
+      }
+
+      generate_testcase(t, sop_off);
+      if (t.symbol_anywhere) { check_bloom(t); }
+      if (sop_off != 0) { pack(tc[prior_i], t); }
+      last[t.chan] = tc.size();
       tc.push_back(t);
-#ifndef OPT_ENABLE_LOGGING
+#ifdef OPT_LOGGING_ENABLE
       if (logging_enable) {
-        std::cout << "[Regress] Generate testcase: " << t.to_string() << "\n";
+        tb::log::Record& r = tb::log::EventLog::local().push();
+        r = tb::log::Record{0, tb::log::Event::TestGenerated,
+                            0, 0, 0, 0, t.id, t.bytes};
       }
 #endif
     }
+
+    if (chan_n > 1) { interleave(tc); }
   }
 
  private:
-  void generate_testcase(tb::TestCase& tc) const {
+  // Match operands shared by the packets of a flow.
+  struct Flow {
+    tb::PacketType type;
+    bool symbol_anywhere = false;
+    std::vector<tb::SymbolMatch> match;
+  };
+
+  // Interleave the packets of distinct channels word by word. Packets
+  // start in order, each once the prior packet of its channel has been
+  // issued in its entirety (a packed word being the initial word of
+  // the packet which it starts); otherwise, the next word is drawn
+  // from a channel selected at random. The stream is then partitioned
+  // such that each testcase holds the words from its SOP up to the
+  // next SOP, as issued by the testbench.
+  static void interleave(std::deque<tb::TestCase>& tc) {
+    std::vector<std::deque<tb::In>> beats(tc.size());
+    for (std::size_t i = 0; i < tc.size(); i++) { beats[i].swap(tc[i].in); }
+
+    // Remaining words of the packet in progress on each channel.
+    std::array<std::deque<tb::In>, tb::CHAN_N> active;
 
-    // Generate stimulus
-    std::int64_t bytes = tb::Random::uniform<std::size_t>(max_len, 1);
+    std::size_t next = 0;
+    std::deque<tb::In>* segment = nullptr;
+    std::vector<std::size_t> options;
+    for (;;) {
+      // Candidate sources: a channel with words remaining, or the
+      // start of the next packet (denoted CHAN_N).
+      options.clear();
+      for (std::size_t c = 0; c < tb::CHAN_N; c++) {
+        if (!active[c].empty()) { options.push_back(c); }
+      }
+      if ((next < tc.size()) && active[tc[next].chan].empty()) {
+        options.push_back(tb::CHAN_N);
+      }
+      if (options.empty()) break;
+
+      std::size_t c = *tb::Random::select_one(options.begin(), options.end());
+      if (c == tb::CHAN_N) {
+        c = tc[next].chan;
+        active[c].swap(beats[next]);
+        segment = &tc[next++].in;
+      }
+      segment->push_back(active[c].front());
+      active[c].pop_front();
+    }
+  }
+
+  // Merge the final word of 'prior' into the initial word of 'next'
+  // such that the word ends one packet and starts the next.
+  static void pack(tb::TestCase& prior, tb::TestCase& next) {
+    tb::In& in = next.in.front();
+    in.eop = true;
+    in.length = prior.in.back().length;
+    in.data |= prior.in.back().data;
+    prior.in.pop_back();
+  }
+
+  void generate_testcase(tb::TestCase& tc, std::size_t sop_off) {
+
+    // Generate stimulus; a packed packet must extend beyond the
+    // shared word.
+    const std::size_t lo =
+        std::max(min_len, (sop_off != 0) ? (9 - sop_off) : 1);
+    const std::size_t bytes = profile_
+        ? std::max(profile_->length->draw(tb::Random::mt()), lo)
+        : tb::Random::uniform<std::size_t>(max_len, lo);
 
     // Set meta-data
     tc.bytes = bytes;
 
-    // Generate input stimulus; interleave packet with some empty
-    // bubble cycles to emulate flow-control on the channel.
+    // Generate the packet as 8B words (as seen by the match logic).
     UniqueRandomIntegral<vluint64_t> gen_data;
-    for (std::size_t i = 0; bytes > 0; ) {
+    std::vector<vluint64_t>& words{tc.words};
+    for (std::size_t i = 0; i < bytes; i += 8) {
+      vluint64_t word = gen_data();
+      if ((bytes - i) < 8) {
+        word &= tb::utility::mask<vluint64_t>((bytes - i) * 8);
+      }
+      words.push_back(word);
+    }
+
+    if (profile_ || (flow_n != 0)) {
+      // Packets of a flow share the operands of the flow, established
+      // by its first packet; each packet matches with the hit ratio of
+      // the profile (or, otherwise, unless failed).
+      const std::size_t flow = profile_
+          ? profile_->flow->draw(tb::Random::mt())
+          : tb::Random::uniform<std::size_t>(flow_n - 1);
+      auto it = flows_.find(flow);
+      if (it == flows_.end()) {
+        it = flows_.emplace(flow, generate_flow(tc, gen_data)).first;
+      }
+      const Flow& f{it->second};
+      tc.flow = flow;
+      tc.type = f.type;
+      tc.symbol_anywhere = f.symbol_anywhere;
+      tc.match = f.match;
+      const double hit_ratio =
+          profile_ ? profile_->hit_ratio : (1.0 - fail_match_probability);
+      if (tb::Random::boolean(hit_ratio)) { plant(tc); }
+    } else {
+      // Generate type oprand
+      generate_type(tc);
+
+      // Generate symbol table oprand
+      generate_symbol_table(tc, gen_data);
+    }
+
+    // Lay the packet out onto the channel at byte offset 'sop_off';
+    // interleave packet with some empty bubble cycles to emulate
+    // flow-control on the channel.
+    const std::size_t beats = (sop_off + bytes + 7) / 8;
+    for (std::size_t i = 0; i < beats; ) {
       tb::In in;
       // Constrain stimulus such that bubble cannot occur on the SOP
-      const bool is_bubble =
-          (i != 0) && tb::Random::boolean(bubble_probability);
+      const bool is_bubble = (i != 0) &&
+          (profile_ ? profile_->bubble->draw(tb::Random::mt())
+                    : tb::Random::boolean(bubble_probability));
       if (!is_bubble) {
         // SOP on first word
         in.valid = true;
+        in.chan = tc.chan;
         in.sop = (i == 0);
-        in.eop = (bytes <= 8);
-        in.length = in.eop ? (bytes - 1) : 0;
-        in.data = gen_data();
-        if (in.eop) { in.data &= tb::utility::mask<vluint64_t>(bytes * 8); }
+        in.sop_off = in.sop ? sop_off : 0;
+        in.eop = (i == (beats - 1));
+        in.length = in.eop ? ((sop_off + bytes - 1) % 8) : 0;
+        in.data = beat(words, sop_off, i);
         i++;
-        bytes -= 8;
       }
       // Otherwise, bubble; Insert empty word.
       
       // Insert stimulus packet.
       tc.in.push_back(in);
     }
+  }
+
+  // Operands of a new flow, independent of the packet contents and
+  // therefore matching only where planted. The type lies within the
+  // initial word, and symbols at fixed offsets within the initial 64B
+  // (or within the packet establishing the flow, where shorter), such
+  // that a match may be planted in any packet of the flow of no fewer
+  // than 64B. Buffers are non-zero, such that every match is apparent
+  // in the verdict.
+  Flow generate_flow(const tb::TestCase& tc,
+                     UniqueRandomIntegral<vluint64_t>& uri) const {
+    Flow f;
+    f.type.off = tb::Random::uniform<std::size_t>(4);
+    f.type.type = tb::Random::uniform<vluint32_t>();
+    f.symbol_anywhere = tb::Random::boolean(symbol_anywhere_probability);
 
+    // Symbols are planted beyond the initial word, which holds the
+    // type.
+    const std::size_t full = tc.bytes / 8;
+    const std::size_t off_hi = std::clamp<std::size_t>(full, 2, 8) - 1;
+    const std::size_t symbols_n =
+        symbol_n ? tb::Random::uniform<std::size_t>(symbol_n, 1) : 0;
+    for (std::size_t i = 0; i < symbols_n; i++) {
+      tb::SymbolMatch symbol;
+      symbol.valid = true;
+      symbol.off = f.symbol_anywhere ? tb::Random::uniform<vluint8_t>()
+                                     : tb::Random::uniform<std::size_t>(off_hi, 1);
+      symbol.match = uri();
+      symbol.buffer = tb::Random::uniform<vluint8_t>(255, 1);
+      f.match.push_back(symbol);
+    }
+    return f;
+  }
 
-    // Generate expected output In -> Out:
-    for (const tb::In& in : tc.in) {
-      // Drop bubbles as we are not interested in these cases.
-      if (in.valid) {
-        tb::Out out;
-        out.valid = true;
-        out.sop = in.sop;
-        out.eop = in.eop;
-        out.length = in.length;
-        out.data = in.data;
-        out.buffer = 0;
+  // Place the type and a symbol of the operands of 'tc' within the
+  // packet, where the packet is of sufficient length; the symbol is
+  // placed beyond the initial word, which holds the type.
+  static void plant(tb::TestCase& tc) {
+    std::vector<vluint64_t>& words{tc.words};
+    auto set_byte = [&](std::size_t i, vluint8_t b) {
+      vluint64_t& w = words[i / 8];
+      w &= ~(static_cast<vluint64_t>(0xFF) << ((i % 8) * 8));
+      w |= (static_cast<vluint64_t>(b) << ((i % 8) * 8));
+    };
 
-        tc.out.push_back(out);
+    if ((tc.type.off + 4) <= tc.bytes) {
+      for (std::size_t i = 0; i < 4; i++) {
+        set_byte(tc.type.off + i, tc.type.type >> (i * 8));
       }
     }
 
-    bool fail = false;
-    
-    // Generate type oprand
-    if (generate_type(tc)) { fail = true; }
+    const std::size_t full = tc.bytes / 8;
+    auto it = tb::Random::select_one(tc.match.begin(), tc.match.end());
+    if ((it == tc.match.end()) || !it->valid || (full < 2)) return;
 
-    // Generate symbol table oprand
-    if (generate_symbol_table(tc, gen_data)) { fail = true; }
+    const std::size_t index = tc.symbol_anywhere
+        ? tb::Random::uniform<std::size_t>(full - 1, 1) : it->off;
+    if (index < full) { words[index] = it->match; }
+  }
 
-    tb::Out& out = tc.out.back();
-    if (fail) { out.buffer = 0; }
+  // Channel word 'i' of packet 'words' starting at byte 'sop_off'.
+  static vluint64_t beat(const std::vector<vluint64_t>& words,
+                         std::size_t sop_off, std::size_t i) {
+    if (sop_off == 0) { return words[i]; }
 
-    // Update testcase meta-data
-    tc.should_match = !fail;
-    if (tc.should_match) { tc.predicted_match = out.buffer; }
+    vluint64_t w = 0;
+    // Final bytes of packet word (i - 1).
+    if (i != 0) { w |= (words[i - 1] >> ((8 - sop_off) * 8)); }
+    // Initial bytes of packet word (i).
+    if (i < words.size()) { w |= (words[i] << (sop_off * 8)); }
+    return w;
   }
 
   // For the input, select some random 4B value within a word and set the
-  // type field.
-  bool generate_type(tb::TestCase& tc) const {
+  // type field. Whether a match takes place is predicted by the
+  // reference model.
+  void generate_type(tb::TestCase& tc) const {
+    const std::vector<vluint64_t>& words{tc.words};
     bool fail = tb::Random::boolean(fail_match_probability);
 
-    std::size_t word_index = tb::Random::uniform<std::size_t>(tc.out.size() - 1);
+    std::size_t word_index = tb::Random::uniform<std::size_t>(words.size() - 1);
 
     // Generate expected offset in the word: 0, 1, 2, 3, 4.
     std::size_t off_index = tb::Random::uniform<std::size_t>(4);
@@ -182,36 +431,27 @@ class TestcaseBuilder {
     tc.type.off = (word_index * 8) + off_index;
 
     // Compute the 'type' field at the nominated regino
-    tc.type.type = (tc.out[word_index].data >> (off_index * 8)) & 0xFFFFFFFF;
+    tc.type.type = (words[word_index] >> (off_index * 8)) & 0xFFFFFFFF;
 
     if (fail) {
       // If require this match to fail, intentionally corrupt the match
       // word at this location so that a match cannot possibly occur.
       tc.type.type = ~tc.type.type;
     }
-
-    // If 'type' fields falls on the last word of the packet, we need
-    // to double check that the word itself constains sufficient bytes
-    // to contain the type field as a function of the alignment. If
-    // not, the RTL will not match against the data.
-    const bool is_last_word = (word_index == tc.out.size() - 1);
-    if (is_last_word) {
-      const tb::Out& out = tc.out.back();
-      
-      if ((out.length + 1) < (off_index + 4)) { fail = true; }
-    }
-
-    return fail;
   }
 
-  bool generate_symbol_table(tb::TestCase& tc,
+  void generate_symbol_table(tb::TestCase& tc,
                              UniqueRandomIntegral<vluint64_t>& uri) const {
+    const std::vector<vluint64_t>& words{tc.words};
 
     bool fail = tb::Random::boolean(fail_match_probability);
         
     const std::size_t symbols_n = tb::Random::uniform<std::size_t>(4, 0);
 
-    vluint8_t buffer = 0;
+    // When symbols may be placed anywhere, offsets are disregarded by
+    // the RTL and are therefore randomized.
+    tc.symbol_anywhere = tb::Random::boolean(symbol_anywhere_probability);
+
     std::vector<tb::SymbolMatch> match;
 
     // Populate symbol table with entries which are guareneed not to
@@ -219,48 +459,62 @@ class TestcaseBuilder {
     for (std::size_t i = 0; i < symbols_n; i++) {
       tb::SymbolMatch symbol;
       symbol.valid = true;
-      symbol.off = 0;
+      symbol.off = tc.symbol_anywhere ? tb::Random::uniform<vluint8_t>() : 0;
       symbol.match = uri();
       symbol.buffer = tb::Random::uniform<vluint8_t>();
       match.push_back(symbol);
     }
 
-    if (match.empty()) { fail = true; }
-
-    if (!fail) {
+    if (!fail && !match.empty()) {
       // Now, generate an entry which we expect to match.
       auto it = tb::Random::select_one(match.begin(), match.end());
       it->valid = true;
 
-      // This is a bit fiddly. When choosing a match symbol in the
-      // symbol, consider the predict output packet as by this point
-      // in the TB the input stimulus has already been inleaved with
-      // bubbles. Would be nice to have this as some final
-      // post-processing set, but would complicate matters somewhat as
-      // the stimulus when then need to be retained in a list instead
-      // of a simpler deque.
-      const std::size_t index = tb::Random::uniform<std::size_t>(tc.out.size() - 1);
-      it->off = index;
-      it->match = tc.out[index].data;
-
-      if (index == (tc.out.size() - 1)) {
-        // If nominated index is the final word in the packet, a match against the
-        // symbol can occur only when the final word is 8B in length. If not, the
-        // match is killed.
-        const tb::In& in = tc.in.back();
-        fail = (in.length != 7);
-      }
-      // Get matching buffer if still matching
-      buffer = it->buffer;
+      // Symbols are matched against the packet words, irrespective
+      // of the alignment of the packet on the channel.
+      const std::size_t index = tb::Random::uniform<std::size_t>(words.size() - 1);
+      if (!tc.symbol_anywhere) { it->off = index; }
+      it->match = words[index];
     }
 
     tc.match = match;
+  }
+
+  // Reference check of the symbol Bloom-filter; a symbol present in
+  // a word must always hit in the filter. Filter hits which do not
+  // correspond to a symbol are confirmed (and discarded) by the exact
+  // comparison in the RTL, and are counted as false-positives.
+  void check_bloom(const tb::TestCase& tc) {
+    const std::vector<vluint64_t>& words{tc.words};
+    tb::BloomFilter f;
+    for (const tb::SymbolMatch& m : tc.match) {
+      if (m.valid) { f.add(m.match); }
+    }
 
-    tb::Out& out = tc.out.back();
-    out.buffer = fail ? 0 : buffer;
+    for (std::size_t i = 0; i < words.size(); i++) {
+      // Only full (8B) words are matchable.
+      if ((i == (words.size() - 1)) && ((tc.bytes % 8) != 0)) continue;
 
-    return fail;
+      bool exact = false;
+      for (const tb::SymbolMatch& m : tc.match) {
+        exact |= (m.valid && (m.match == words[i]));
+      }
+      const bool hit = f.hit(words[i]);
+      EXPECT_TRUE(hit || !exact) << "Bloom filter false-negative";
+
+      bloom_stats.words++;
+      if (hit) {
+        bloom_stats.hits++;
+        if (!exact) { bloom_stats.false_positives++; }
+      }
+    }
   }
+
+  // Selected traffic profile (if any).
+  std::unique_ptr<m::traffic::Profile> profile_;
+
+  // Operands of established flows.
+  std::map<std::size_t, Flow> flows_;
 };
 
 class RegressEnvironment {
@@ -272,6 +526,9 @@ class RegressEnvironment {
   // Total number of test cases.
   std::size_t n = 1;
 
+  // Minimum number of bytes within a packet
+  std::size_t min_len = 1;
+
   // Maximum number of bytes within a packet
   std::size_t max_len = 1500;
 
@@ -285,6 +542,43 @@ class RegressEnvironment {
   // Probability of a match not taking place.
   double fail_match_probability = 0.1;
 
+  // Probability of symbols matched irrespective of word offset.
+  double symbol_anywhere_probability = 0.0;
+
+  // Probability of a packet starting in the final word of the prior
+  // packet (of the same channel).
+  double pack_probability = 0.0;
+
+  // Number of interleaved channels (see: TestcaseBuilder::chan_n).
+  std::size_t chan_n = 1;
+
+  // Number of flows (see: TestcaseBuilder::flow_n).
+  std::size_t flow_n = 0;
+
+  // Traffic profile (see: TestcaseBuilder::profile).
+  std::string profile;
+
+  // Egress configuration (see: tb::Options).
+  tb::EgressConfig egress;
+
+  // Completion configuration and consumer service latency (see:
+  // tb::Options).
+  tb::CplConfig cpl;
+  std::size_t cpl_service_latency = 0;
+
+  // Clock half-periods (see: tb::Options).
+  vluint64_t net_half_period = tb::Options{}.net_half_period;
+  vluint64_t host_half_period = tb::Options{}.host_half_period;
+
+  // Bloom-filter statistics of the completed run.
+  BloomStats bloom_stats;
+
+  // Distinct flows of the generated stimulus.
+  std::size_t flows = 0;
+
+  // Testbench statistics of the completed run.
+  tb::TB::Stats tb_stats;
+
   // Enable verbose logging in the testbench
   bool logging_enable = false;
 
@@ -299,15 +593,35 @@ class RegressEnvironment {
 
     tb::utility::KVListRenderer r;
     r.add_field("n", to_string(n));
+    r.add_field("min_len", to_string(min_len));
     r.add_field("max_len", to_string(max_len));
     r.add_field("symbol_n", to_string(symbol_n));
     r.add_field("bubble_probability", to_string(bubble_probability));
     r.add_field("fail_match_probability", to_string(fail_match_probability));
+    r.add_field("pack_probability", to_string(pack_probability));
+    r.add_field("chan_n", to_string(chan_n));
+    if (flow_n != 0) { r.add_field("flow_n", to_string(flow_n)); }
+    if (!profile.empty()) { r.add_field("profile", profile); }
+    if (egress.mode != tb::EgressMode::Forward) {
+      r.add_field("egress_mode", to_string(static_cast<int>(egress.mode)));
+      r.add_field("egress_hdr", to_string(egress.hdr));
+      r.add_field("egress_depth", to_string(egress.depth));
+    }
+    if ((cpl.count != 1) || (cpl.timeout != 0)) {
+      r.add_field("cpl_count", to_string(cpl.count));
+      r.add_field("cpl_timeout", to_string(cpl.timeout));
+    }
     return r.to_string();
   }
 
-  void run() const {
+  // Testbench options of the environment.
+  tb::Options options() const {
     tb::Options opts;
+    opts.net_half_period = net_half_period;
+    opts.host_half_period = host_half_period;
+    opts.egress = egress;
+    opts.cpl = cpl;
+    opts.cpl_service_latency = cpl_service_latency;
 #ifdef OPT_VCD_ENABLE
     // Enable waveforms
     opts.vcd_enable = true;
@@ -315,25 +629,79 @@ class RegressEnvironment {
 #endif
 #ifdef OPT_LOGGING_ENABLE
     opts.logging_enable = logging_enable;
+#endif
+    return opts;
+  }
 
-    std::cout << "[Regress] Constructing test environment: "
-              << to_string() << "\n";
+  // Generate the stimulus of the environment.
+  void build(std::deque<tb::TestCase>& tests) {
+#ifdef OPT_LOGGING_ENABLE
+    if (logging_enable) {
+      const float fail = fail_match_probability;
+      const float bubble = bubble_probability;
+      std::uint32_t fail_bits, bubble_bits;
+      std::memcpy(&fail_bits, &fail, sizeof(float));
+      std::memcpy(&bubble_bits, &bubble, sizeof(float));
+
+      tb::log::EventLog::local().context(
+          tb::log::Record{0, tb::log::Event::Environment, 0,
+                          static_cast<std::uint8_t>(symbol_n), 0,
+                          static_cast<std::uint32_t>(n), max_len,
+                          (static_cast<std::uint64_t>(fail_bits) << 32) |
+                          bubble_bits});
+    }
 #endif
   
-    tb::TB tb(opts);
     TestcaseBuilder tcb;
 #ifdef OPT_LOGGING_ENABLE
     tcb.logging_enable = logging_enable;
 #endif
     tcb.n = n;
+    tcb.min_len = min_len;
     tcb.max_len = max_len;
     tcb.symbol_n = symbol_n;
     tcb.bubble_probability = bubble_probability;
     tcb.fail_match_probability = fail_match_probability;
-    
-    std::deque<tb::TestCase> tests;
+    tcb.symbol_anywhere_probability = symbol_anywhere_probability;
+    tcb.pack_probability = pack_probability;
+    tcb.chan_n = chan_n;
+    tcb.flow_n = flow_n;
+    tcb.profile = profile;
+
     tcb.build(tests);
+    bloom_stats = tcb.bloom_stats;
+    flows = tcb.flows();
+  }
+
+  // Retire the completed run of the environment.
+  void complete(const tb::TB::Stats& stats) {
+    tb_stats = stats;
+
+    // All packets must have been predicted to completion.
+    EXPECT_EQ(tb_stats.packets, n);
+  }
+
+  void run() {
+#ifdef OPT_PROF_ENABLE
+    // Environment is profiled as a single run.
+    const testing::TestInfo* ti =
+        testing::UnitTest::GetInstance()->current_test_info();
+    tb::prof::RunScope run_scope{std::string{ti->test_suite_name()} + "." +
+                                 ti->name() + "/" + name_};
+#endif
+    tb::TB tb(options());
+    std::deque<tb::TestCase> tests;
+    {
+#ifdef OPT_PROF_ENABLE
+      tb::prof::Scope scope{tb::prof::Section::Generate};
+#endif
+      build(tests);
+    }
     tb.run(tests);
+#ifdef OPT_PROF_ENABLE
+    tb::prof::Scope scope{tb::prof::Section::Complete};
+#endif
+    complete(tb.stats());
   }
 
  private:
@@ -378,3 +746,459 @@ TEST(regress, full) {
     r.run();
   }
 }
+
+TEST(regress, symbol_anywhere) {
+  // Fully randomized, self-checking testbench with symbols matched at
+  // any word within the packet.
+  BloomStats stats;
+  for (std::size_t round = 0; round < 100; round++) {
+    const unsigned seed = tb::Random::uniform<unsigned>();
+    const std::string testname = "regress" + std::to_string(round);
+    RegressEnvironment r{testname, seed};
+    r.id = round;
+    r.n = 1000;
+    r.max_len = tb::Random::uniform<std::size_t>(1500, 1);
+    r.symbol_n = tb::Random::uniform<std::size_t>(4, 1);
+    r.bubble_probability = tb::Random::uniform<double>(0.0, 0.2);
+    r.fail_match_probability = tb::Random::uniform<double>(0.1, 0.9);
+    r.symbol_anywhere_probability = 1.0;
+#ifdef OPT_LOGGING_ENABLE
+    r.logging_enable = true;
+#endif
+    r.run();
+    stats += r.bloom_stats;
+  }
+
+  RecordProperty("bloom_words", std::to_string(stats.words));
+  RecordProperty("bloom_hits", std::to_string(stats.hits));
+  RecordProperty("bloom_false_positives",
+                 std::to_string(stats.false_positives));
+  std::cout << "[Regress] Bloom filter: words:" << stats.words
+            << " hits:" << stats.hits
+            << " false_positives:" << stats.false_positives << "\n";
+}
+
+TEST(regress, packed) {
+  // Fully randomized, self-checking testbench with back-to-back
+  // packets packed such that a word ends one packet and starts the
+  // next.
+  for (std::size_t round = 0; round < 100; round++) {
+    const unsigned seed = tb::Random::uniform<unsigned>();
+    const std::string testname = "regress" + std::to_string(round);
+    RegressEnvironment r{testname, seed};
+    r.id = round;
+    r.n = 1000;
+    r.max_len = tb::Random::uniform<std::size_t>(128, 1);
+    r.symbol_n = tb::Random::uniform<std::size_t>(4, 1);
+    r.bubble_probability = tb::Random::uniform<double>(0.0, 0.2);
+    r.fail_match_probability = tb::Random::uniform<double>(0.1, 0.9);
+    r.symbol_anywhere_probability = 0.5;
+    r.pack_probability = tb::Random::uniform<double>(0.5, 1.0);
+#ifdef OPT_LOGGING_ENABLE
+    r.logging_enable = true;
+#endif
+    r.run();
+  }
+}
+
+TEST(regress, interleaved) {
+  // Fully randomized, self-checking testbench with the packets of up
+  // to CHAN_N channels interleaved word by word.
+  for (std::size_t round = 0; round < 100; round++) {
+    const unsigned seed = tb::Random::uniform<unsigned>();
+    const std::string testname = "interleaved" + std::to_string(round);
+    RegressEnvironment r{testname, seed};
+    r.id = round;
+    r.n = 1000;
+    r.chan_n = tb::Random::uniform<std::size_t>(tb::CHAN_N, 2);
+    r.max_len = tb::Random::uniform<std::size_t>(256, 1);
+    r.symbol_n = tb::Random::uniform<std::size_t>(4, 1);
+    r.bubble_probability = tb::Random::uniform<double>(0.0, 0.2);
+    r.fail_match_probability = tb::Random::uniform<double>(0.1, 0.9);
+    r.symbol_anywhere_probability = 0.5;
+    r.pack_probability = tb::Random::uniform<double>(0.0, 1.0);
+#ifdef OPT_LOGGING_ENABLE
+    r.logging_enable = true;
+#endif
+    r.run();
+  }
+}
+
+TEST(regress, filter) {
+  // Self-checking testbench with packets filtered at the egress; only
+  // packets which match (or their initial words, where truncated) are
+  // delivered to the host.
+  std::size_t in_words = 0, out_words = 0;
+  for (std::size_t round = 0; round < 100; round++) {
+    const unsigned seed = tb::Random::uniform<unsigned>();
+    const std::string testname = "filter" + std::to_string(round);
+    RegressEnvironment r{testname, seed};
+    r.id = round;
+    r.n = 1000;
+    r.symbol_n = tb::Random::uniform<std::size_t>(4, 1);
+    r.symbol_anywhere_probability = 0.5;
+    r.pack_probability = tb::Random::uniform<double>(0.0, 1.0);
+    r.egress.mode = (round % 2) ? tb::EgressMode::Truncate
+                                : tb::EgressMode::Filter;
+    r.egress.hdr = tb::Random::uniform<std::size_t>(4, 0);
+
+    // In half of the rounds (of either mode), the buffer is restricted
+    // such that only the smallest packets of the mix fit, and larger
+    // packets overflow. Small packets occupy no more than half of the
+    // buffer, such that overflow never depends upon the words of prior
+    // packets yet to drain to the host (see: tb::EgressModel).
+    const bool is_overflow = (round % 4) >= 2;
+    if (is_overflow) {
+      r.profile = "imix";
+      r.egress.depth = 64;
+    } else {
+      r.chan_n = tb::Random::uniform<std::size_t>(tb::CHAN_N, 1);
+      r.max_len = tb::Random::uniform<std::size_t>(1500, 1);
+      r.bubble_probability = tb::Random::uniform<double>(0.0, 0.2);
+      r.fail_match_probability = tb::Random::uniform<double>(0.1, 0.9);
+    }
+#ifdef OPT_LOGGING_ENABLE
+    r.logging_enable = true;
+#endif
+    r.run();
+
+    const tb::TB::Stats& s{r.tb_stats};
+    if (is_overflow) {
+      EXPECT_GT(s.egress_overflows, 0);
+      EXPECT_LE(s.delivered + s.egress_overflows, s.packets);
+    } else if ((r.egress.mode == tb::EgressMode::Filter) ||
+               (r.egress.hdr == 0)) {
+      // Packets which do not match are discarded.
+      EXPECT_EQ(s.delivered, s.matched);
+    } else {
+      EXPECT_EQ(s.delivered, s.packets);
+    }
+    in_words += s.in_words;
+    out_words += s.out_words;
+  }
+
+  RecordProperty("in_words", std::to_string(in_words));
+  RecordProperty("out_words", std::to_string(out_words));
+  std::cout << "[Regress] Filtered egress: in_words:" << in_words
+            << " out_words:" << out_words << "\n";
+}
+
+TEST(regress, stress) {
+  // Worst-case line-rate stress of the NET to HOST clock-crossing:
+  // no bubbles, back-to-back packets of minimum size, in long bursts
+  // of maximum size, or of a single word (every word EOP, such that
+  // the verdict path is as busy as the data path), across a range of
+  // HOST clock frequencies down to that of the NET clock. Where
+  // packets are filtered, the egress stage stalls the clock-crossing
+  // for a HOST cycle on each packed word, and the HOST clock must be
+  // no slower than twice the NET clock. Packets of a single word are
+  // of a single flow, whose rule set is written once ahead of the
+  // stimulus, such that ingress is not bound by rule set commits.
+  struct Clocking {
+    vluint64_t host_half_period;
+    tb::EgressMode mode;
+  };
+  for (const Clocking& c : {Clocking{5, tb::EgressMode::Forward},
+                            Clocking{7, tb::EgressMode::Forward},
+                            Clocking{10, tb::EgressMode::Forward},
+                            Clocking{5, tb::EgressMode::Filter}}) {
+    const bool is_filter = (c.mode == tb::EgressMode::Filter);
+    const std::string suffix =
+        std::to_string(c.host_half_period) + (is_filter ? "_filter" : "");
+    for (std::size_t round = 0; round < 12; round++) {
+      const unsigned seed = tb::Random::uniform<unsigned>();
+      const std::string testname = "stress" + std::to_string(round);
+      RegressEnvironment r{testname, seed};
+      r.id = round;
+      r.n = 1000;
+      switch (round % 3) {
+        case 0: r.min_len = 60; r.max_len = 64; break;
+        case 1: r.min_len = 1500; r.max_len = 1500; break;
+        default: r.min_len = 1; r.max_len = 8; r.flow_n = 1; break;
+      }
+      r.symbol_n = tb::Random::uniform<std::size_t>(4, 1);
+      r.bubble_probability = 0.0;
+      r.fail_match_probability = tb::Random::uniform<double>(0.1, 0.9);
+      r.pack_probability = 1.0;
+      r.host_half_period = c.host_half_period;
+      r.egress.mode = c.mode;
+      r.run();
+
+      const tb::TB::Stats& s{r.tb_stats};
+      const vluint64_t net_period = 2 * r.net_half_period;
+
+      // The clock-crossing queues must never overflow.
+      EXPECT_EQ(s.afifo_overflows, 0);
+      EXPECT_LE(s.afifo_high_water, tb::AFIFO_N);
+      EXPECT_EQ(s.vfifo_overflows, 0);
+      EXPECT_LE(s.vfifo_high_water, tb::VFIFO_N);
+      EXPECT_LE(s.vfifo_high_water, s.afifo_high_water);
+
+      // Ingress must have been saturated for the duration of the run;
+      // the clock-crossing never refuses a word.
+      EXPECT_EQ((s.in_last - s.in_first) / net_period, s.in_words - 1);
+
+      // Sustained egress throughput must equal ingress throughput;
+      // egress may lag ingress by no more than the depth of the
+      // queue. (Where packets are filtered, egress is delayed by the
+      // store-and-forward buffer and carries only matching packets.)
+      if (!is_filter) {
+        EXPECT_EQ(s.out_words, s.in_words);
+        const vluint64_t in_span = s.in_last - s.in_first;
+        const vluint64_t out_span = s.out_last - s.out_first;
+        EXPECT_LE(out_span, in_span + (tb::AFIFO_N * net_period));
+      }
+
+      RecordProperty("afifo_high_water_" + suffix,
+                     std::to_string(s.afifo_high_water));
+      RecordProperty("vfifo_high_water_" + suffix,
+                     std::to_string(s.vfifo_high_water));
+    }
+  }
+
+  // Storage of the clock-crossing; the sideband is retained once per
+  // packet (verdict path) rather than once per word, in a queue
+  // shallower than the data path.
+  const std::size_t unified = tb::AFIFO_N * tb::OUT_W;
+  const std::size_t data = tb::AFIFO_N * tb::AFIFO_W;
+  const std::size_t verdict = tb::VFIFO_N * tb::VFIFO_W;
+  EXPECT_LT(data + verdict, unified);
+  std::cout << "[Regress] Clock-crossing storage (bits): unified:" << unified
+            << " data:" << data << " verdict:" << verdict
+            << " saved:" << (unified - (data + verdict)) << "\n";
+}
+
+TEST(regress, profiles) {
+  // Self-checking testbench driven by each of the registered traffic
+  // profiles: realistic length mixes, bursty arrivals and flows
+  // recurring over a common set of rules. Each profile is also run
+  // with its hit ratio overridden by name.
+  std::vector<std::string> profiles;
+  for (const std::string& profile : m::traffic::profile_names()) {
+    profiles.push_back(profile);
+    profiles.push_back(profile + ":hit=0.9");
+  }
+  for (const std::string& profile : profiles) {
+    for (std::size_t round = 0; round < 10; round++) {
+      const unsigned seed = tb::Random::uniform<unsigned>();
+      // Overrides are not valid within a property (or file) name.
+      std::string testname = profile + std::to_string(round);
+      std::replace_if(testname.begin(), testname.end(),
+                      [](char c) { return (c == ':') || (c == '='); }, '_');
+      RegressEnvironment r{testname, seed};
+      r.id = round;
+      r.n = 1000;
+      r.symbol_n = tb::Random::uniform<std::size_t>(4, 1);
+      r.symbol_anywhere_probability = 0.5;
+      r.pack_probability = (round % 2) ? 0.5 : 0.0;
+      r.profile = profile;
+      r.run();
+
+      RecordProperty("matched_" + testname,
+                     std::to_string(r.tb_stats.matched));
+      RecordProperty("rule_writes_" + testname,
+                     std::to_string(r.tb_stats.rule_writes));
+
+      // A rule set is written on the first packet of each flow, and
+      // thereafter only where the flow has been evicted; packets of a
+      // resident flow write nothing.
+      EXPECT_GE(r.tb_stats.rule_writes, r.flows) << testname;
+      EXPECT_LE(r.tb_stats.rule_writes, r.tb_stats.packets) << testname;
+      if (r.flows < r.tb_stats.packets) {
+        EXPECT_LT(r.tb_stats.rule_writes, r.tb_stats.packets) << testname;
+      }
+
+      // The realised hit ratio is that of the profile, to within the
+      // sampling error of the round.
+      const double p = m::traffic::make_profile(profile)->hit_ratio;
+      const double n = static_cast<double>(r.tb_stats.packets);
+      const double realised = static_cast<double>(r.tb_stats.matched) / n;
+      EXPECT_NEAR(realised, p, (4.0 * std::sqrt(p * (1.0 - p) / n)) + 0.01)
+          << testname;
+    }
+  }
+}
+
+TEST(regress, lockstep) {
+  // Fully randomized, self-checking testbench with K independent
+  // environments simulated in lockstep, one per instance of the DUT.
+  // The stimulus of each environment is then simulated alone (on the
+  // first instance), and each instance must have produced identical
+  // egress in lockstep.
+  if (tb::K < 2) {
+    GTEST_SKIP() << "Requires OPT_TB_K >= 2 (configured: " << tb::K << ")";
+  }
+  std::size_t packets = 0;
+  std::chrono::duration<double> elapsed{0};
+  for (std::size_t round = 0; round < 10; round++) {
+    std::vector<RegressEnvironment> envs;
+    std::vector<std::deque<tb::TestCase>> tests(tb::K);
+    for (std::size_t k = 0; k < tb::K; k++) {
+      const unsigned seed = tb::Random::uniform<unsigned>();
+      const std::string testname =
+          "lockstep" + std::to_string(round) + "_" + std::to_string(k);
+      RegressEnvironment& r = envs.emplace_back(testname, seed);
+      r.id = round;
+      r.n = 1000;
+      r.max_len = tb::Random::uniform<std::size_t>(1500, 1);
+      r.symbol_n = tb::Random::uniform<std::size_t>(4, 1);
+      r.bubble_probability = tb::Random::uniform<double>(0.0, 0.2);
+      r.fail_match_probability = tb::Random::uniform<double>(0.1, 0.9);
+      r.symbol_anywhere_probability = 0.5;
+      r.pack_probability = tb::Random::uniform<double>(0.0, 0.5);
+      r.build(tests[k]);
+    }
+    const std::vector<std::deque<tb::TestCase>> stimulus{tests};
+
+    const auto start = std::chrono::steady_clock::now();
+    tb::TB tb(envs.front().options());
+    tb.run(tests);
+    elapsed += std::chrono::steady_clock::now() - start;
+    for (std::size_t k = 0; k < tb::K; k++) {
+      envs[k].complete(tb.stats(k));
+      packets += envs[k].tb_stats.packets;
+    }
+
+    for (std::size_t k = 0; k < tb::K; k++) {
+      std::deque<tb::TestCase> solo_tests{stimulus[k]};
+      tb::TB solo(envs[k].options());
+      solo.run(solo_tests);
+      const tb::TB::Stats& s{solo.stats()};
+      const tb::TB::Stats& l{tb.stats(k)};
+      EXPECT_EQ(l.packets, s.packets);
+      EXPECT_EQ(l.matched, s.matched);
+      EXPECT_EQ(l.out_words, s.out_words);
+      EXPECT_EQ(l.out_digest, s.out_digest)
+          << "Egress of instance " << k << " differs in lockstep";
+    }
+  }
+
+  std::cout << "[Regress] Lockstep: instances:" << tb::K
+            << " packets:" << packets
+            << " packets/s:" << (packets / elapsed.count()) << "\n";
+}
+
+TEST(regress, match_depth) {
+  // Identical stimulus is issued to each instance of the DUT; as the
+  // instances sweep the match pipeline depth, the egress of every
+  // instance must be identical irrespective of depth. Every depth is
+  // compared only where there are at least as many instances.
+  constexpr std::size_t DEPTH_N = tb::MATCH_DEPTH_MAX + 1;
+  if (tb::K < DEPTH_N) {
+    GTEST_SKIP() << "Requires OPT_TB_K >= " << DEPTH_N
+                 << " (configured: " << tb::K << ")";
+  }
+  for (std::size_t round = 0; round < 10; round++) {
+    const unsigned seed = tb::Random::uniform<unsigned>();
+    const std::string testname = "match_depth" + std::to_string(round);
+    RegressEnvironment r{testname, seed};
+    r.id = round;
+    r.n = 1000;
+    r.max_len = tb::Random::uniform<std::size_t>(256, 1);
+    r.symbol_n = tb::Random::uniform<std::size_t>(4, 1);
+    r.bubble_probability = tb::Random::uniform<double>(0.0, 0.2);
+    r.fail_match_probability = tb::Random::uniform<double>(0.1, 0.9);
+    r.symbol_anywhere_probability = 0.5;
+    r.pack_probability = tb::Random::uniform<double>(0.0, 1.0);
+
+    std::vector<std::deque<tb::TestCase>> tests(1);
+    r.build(tests.front());
+    tests.resize(tb::K, tests.front());
+
+    tb::TB tb(r.options());
+    tb.run(tests);
+    r.complete(tb.stats(0));
+    for (std::size_t k = 1; k < tb::K; k++) {
+      const tb::TB::Stats& s{tb.stats(k)};
+      EXPECT_EQ(s.packets, r.tb_stats.packets);
+      EXPECT_EQ(s.matched, r.tb_stats.matched);
+      EXPECT_EQ(s.out_words, r.tb_stats.out_words);
+      EXPECT_EQ(s.out_digest, r.tb_stats.out_digest)
+          << "Egress differs between match depths "
+          << tb::match_depth(0) << " and " << tb::match_depth(k);
+    }
+  }
+}
+
+TEST(regress, completion) {
+  // Identical stimulus is issued under a range of completion
+  // coalescing configurations. Coalescing trades the rate of
+  // notifications raised to the host against the latency with which
+  // completed packets are consumed; every packet delivered must
+  // nonetheless be reported by exactly one descriptor.
+  struct Point {
+    std::size_t count;
+    std::size_t timeout;
+  };
+  const std::array<Point, 6> points{{
+      {1, 0}, {4, 0}, {16, 0}, {32, 0}, {16, 64}, {32, 256}}};
+  constexpr std::size_t service_latency = 8;
+
+  for (std::size_t round = 0; round < 4; round++) {
+    const unsigned seed = tb::Random::uniform<unsigned>();
+    std::size_t descriptors = 0;
+    std::size_t notifications = 0;
+    for (const Point& p : points) {
+      const std::string testname = "completion" + std::to_string(round) +
+                                   "_" + std::to_string(p.count) + "_" +
+                                   std::to_string(p.timeout);
+      RegressEnvironment r{testname, seed};
+      r.id = round;
+      r.n = 2000;
+      r.symbol_n = 4;
+      r.symbol_anywhere_probability = 0.5;
+      r.pack_probability = 0.5;
+      r.chan_n = tb::CHAN_N;
+      r.profile = "imix";
+      r.egress.mode = (round % 2) ? tb::EgressMode::Truncate
+                                  : tb::EgressMode::Forward;
+      r.cpl.count = p.count;
+      r.cpl.timeout = p.timeout;
+      r.cpl_service_latency = service_latency;
+      r.run();
+
+      const tb::TB::Stats& s{r.tb_stats};
+
+      // One descriptor is consumed per packet delivered.
+      EXPECT_EQ(s.cpl_descriptors, s.delivered);
+      EXPECT_EQ(s.cpl_overflows, 0);
+      if (p.timeout == 0) {
+        // Notifications are raised on every 'count' descriptors; those
+        // which remain are consumed once stimulus is exhausted.
+        EXPECT_EQ(s.cpl_notifications, s.cpl_descriptors / p.count);
+      } else {
+        // The timeout raises additional notifications, and bounds the
+        // latency of every descriptor.
+        EXPECT_GE(s.cpl_notifications, s.cpl_descriptors / p.count);
+        EXPECT_LE(s.cpl_latency_max,
+                  p.timeout + service_latency + tb::CPL_N + 4);
+      }
+
+      // Stimulus is identical across the configurations; without a
+      // timeout, notifications decrease as the count increases.
+      if (p.count == 1) {
+        descriptors = s.cpl_descriptors;
+      } else {
+        EXPECT_EQ(s.cpl_descriptors, descriptors);
+      }
+      if (p.timeout == 0) {
+        if (p.count != 1) { EXPECT_LE(s.cpl_notifications, notifications); }
+        notifications = s.cpl_notifications;
+      }
+
+      const double rate = static_cast<double>(s.cpl_notifications) /
+                          std::max<std::size_t>(s.cpl_descriptors, 1);
+      const double latency = static_cast<double>(s.cpl_latency_sum) /
+                             std::max<std::size_t>(s.cpl_descriptors, 1);
+      RecordProperty("notifications_" + testname,
+                     std::to_string(s.cpl_notifications));
+      if (round == 0) {
+        std::cout << "[Regress] Completion: count:" << p.count
+                  << " timeout:" << p.timeout
+                  << " notifications/descriptor:" << rate
+                  << " latency_mean:" << latency
+                  << " latency_max:" << s.cpl_latency_max << "\n";
+      }
+    }
+  }
+}
@@ -58,7 +58,6 @@ TEST(smoke, passthru) {
 
   // Set meta-data on directed test.
   tc.id = 0;
-  tc.should_match = false;
   tc.bytes = beats * 8;
 
   // Construct input stimulus:
@@ -73,22 +72,14 @@ TEST(smoke, passthru) {
     tc.in.push_back(in);
   }
 
-  // Construct expected output:
-  //
-  for (std::size_t i = 0; i < beats; i++) {
-    tb::Out out;
-    out.valid = true;
-    out.sop = (i == 0);
-    out.eop = (i == (beats - 1));
-    if (out.eop) { out.length = 7; }
-    // In -> Out; data is not changed.
-    out.data = tc.in[i].data;
-    out.buffer = 0;
-    tc.out.push_back(out);
-  }
   tests.push_back(tc);
   
   tb.run(tests);
+
+  // Output is checked against the reference model; no match
+  // operands, therefore no match.
+  EXPECT_EQ(tb.stats().packets, 1);
+  EXPECT_EQ(tb.stats().matched, 0);
 }
 
 TEST(smoke, simple_match) {
@@ -121,8 +112,6 @@ TEST(smoke, simple_match) {
 
     // Set meta data;
     tc.id = round;
-    tc.should_match = true;
-    tc.predicted_match = buffer;
     tc.bytes = (beats * 8);
 
     // In:
@@ -138,19 +127,6 @@ TEST(smoke, simple_match) {
       tc.in.push_back(in);
     }
 
-    // Out:
-    for (std::size_t i = 0; i < beats; i++) {
-      tb::Out out;
-      out.valid = true;
-      out.sop = (i == 0);
-      out.eop = (i == (beats - 1));
-      out.length = out.eop ? 7 : 0;
-      // In -> Out; data is not changed.
-      out.data = tc.in[i].data;
-      out.buffer = out.eop ? buffer : 0;
-      tc.out.push_back(out);
-    }
-
     // Packet type
     tb::PacketType t;
     t.off = 0;
@@ -172,4 +148,10 @@ TEST(smoke, simple_match) {
   
   tb::TB tb(opts);
   tb.run(tests);
+
+  // Output is checked against the reference model; every packet
+  // must match (a match on buffer zero is indistinguishable from no
+  // match).
+  EXPECT_EQ(tb.stats().packets, rounds);
+  EXPECT_EQ(tb.stats().matched, (buffer != 0) ? rounds : 0);
 }